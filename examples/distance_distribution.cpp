@@ -4,7 +4,9 @@ using namespace bgl;
 int main(int argc, char **argv) {
   bgl_app app("Compute approximate distance distribution using HyperBall");
   int log2k = 10;
+  bool packed = false;
   app.add_option("-b,--log2k", log2k, "Control number of registers of HyperLogLog (default: 10)");
+  app.add_flag("--packed", packed, "Use 5-bit registers of HyperLogLog to save memory");
   BGL_PARSE(app, argc, argv);
 
   for (auto [g, p] : app.graph_iterator<graph>()) {
@@ -12,12 +14,9 @@ int main(int argc, char **argv) {
     CONSOLE_LOG("graph loaded: {}\n  # of nodes: {}\n  # of edges: {}", p, commify(g.num_nodes()),
                 commify(g.num_edges()));
 
-    std::vector<std::atomic<double>> distance_distribution(101);
-    hyperball(g, log2k, fn(v[[maybe_unused]], d, c) {
-      double cur = distance_distribution[d];
-      while (!distance_distribution[d].compare_exchange_weak(cur, cur + c)) continue;
-    });
+    auto result = packed ? hyperball_centralities<packed_hyperloglog_array<5>>(g, log2k)
+                         : hyperball_centralities(g, log2k);
 
-    fmt::print("distance distribution:\n{}\n", distance_distribution);
+    fmt::print("distance distribution:\n{}\n", result.distance_distribution);
   }
 }
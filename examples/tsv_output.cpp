@@ -3,17 +3,23 @@ using namespace bgl;
 
 int main(int argc, char **argv) {
   bgl_app app("Output tsv formatted graph file");
+  int level = 0;
+  app.add_option("-z,--zstd", level, "Compress output by zstd with specified level (0: disabled)");
   BGL_PARSE(app, argc, argv);
 
   for (auto [g, p] : app.graph_iterator<graph>()) {
     path out_path = p;
     if (out_path.extension() == ".zst") out_path.replace_extension("");
-    out_path.replace_extension(".tsv");
+    out_path.replace_extension(level > 0 ? ".tsv.zst" : ".tsv");
     EXPECT_MSG(!path::exists(out_path), "overwrite {}", out_path);
 
     CONSOLE_LOG("graph loaded: {}\n  # of nodes: {}\n  # of edges: {}", p, commify(g.num_nodes()),
                 commify(g.num_edges()));
 
-    write_graph_tsv(out_path, g, false);
+    if (level > 0) {
+      write_graph_tsv_zstd(out_path, g, level, 0, false);
+    } else {
+      write_graph_tsv(out_path, g, false);
+    }
   }
 }
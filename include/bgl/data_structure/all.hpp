@@ -1,5 +1,6 @@
 #pragma once
 
 #include "aligned_array.hpp"
+#include "concurrent_union_find.hpp"
 #include "hyperloglog_array.hpp"
 #include "union_find.hpp"
@@ -0,0 +1,113 @@
+#pragma once
+#include "bgl/util/all.hpp"
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// disjoint-set data structure that can be updated by multiple threads concurrently
+/// (e.g., inside |for_each_node|): no operation takes a lock.
+/// sets are linked by index: the root of a set is always its smallest element, and |unite|
+/// hooks the larger root under the smaller one by CAS. |find| shortens the path by path halving
+/// with a single CAS attempt per step, so it never waits for other threads.
+/// every parent only moves toward the root, so a stale read merely gives a longer path.
+/// @see "Wait-free parallel algorithms for the union-find problem"
+///      (R. J. Anderson and H. Woll). In STOC'91.
+template <typename T, typename = std::enable_if<std::is_integral_v<T>>>
+class concurrent_union_find {
+public:
+  using integral_t = T;
+
+  /// class initialization: O(n)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  concurrent_union_find(integral_t count, int num_threads = 0) : count_{count}, parent_(count) {
+    parallel_for(
+        count, kParallelUnit,
+        fn(i, t [[maybe_unused]]) { parent_[i].store(i, std::memory_order_relaxed); },
+        num_threads);
+  }
+
+  /// merge sets that includes x and includes y: approximately O(1)
+  /// @return true if they were different sets
+  bool unite(integral_t x, integral_t y) {
+    while (true) {
+      x = find(x);
+      y = find(y);
+      if (x == y) return false;
+      if (x < y) std::swap(x, y);
+      // fails if |x| is no longer a root: retry from the new root
+      integral_t expected = x;
+      if (parent_[x].compare_exchange_weak(expected, y, std::memory_order_relaxed)) {
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+
+  /// merge sets of (|p.first|, |p.second|) for each pair |p| of |pairs| in parallel
+  /// (e.g., unweighted |edge_list|)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  template <typename Pairs>
+  void unite_all(const Pairs &pairs, int num_threads = 0) {
+    parallel_for(
+        pairs.size(), kParallelUnit,
+        fn(i, t [[maybe_unused]]) { unite(pairs[i].first, pairs[i].second); }, num_threads);
+  }
+
+  /// determine if x and y are included by the same set: approximately O(1)
+  bool is_same(integral_t x, integral_t y) {
+    while (true) {
+      x = find(x);
+      y = find(y);
+      if (x == y) return true;
+      // |x| may have been merged after |find(x)|: the answer is valid only if it is still a root
+      if (parent_[x].load(std::memory_order_relaxed) == x) return false;
+    }
+  }
+
+  /// find representative ID (smallest element of the set): approximately O(1)
+  integral_t find(integral_t x) {
+    while (true) {
+      integral_t p = parent_[x].load(std::memory_order_relaxed);
+      if (p == x) return x;
+      integral_t gp = parent_[p].load(std::memory_order_relaxed);
+      if (p != gp) parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+      x = gp;
+    }
+  }
+
+  /// return the number of disjoint sets: O(1)
+  integral_t disjoint_count() const { return count_.load(std::memory_order_relaxed); }
+
+  /// make every element point to its representative directly: O(n)
+  /// (must not be called concurrently with |unite|)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  void compress(int num_threads = 0) {
+    parallel_for(
+        parent_.size(), kParallelUnit,
+        fn(i, t [[maybe_unused]]) { parent_[i].store(find(i), std::memory_order_relaxed); },
+        num_threads);
+  }
+
+  /// return list of component IDs (representative IDs)
+  /// (must not be called concurrently with |unite|)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  std::vector<integral_t> components(int num_threads = 0) {
+    compress(num_threads);
+    std::vector<integral_t> result(parent_.size());
+    parallel_for(
+        parent_.size(), kParallelUnit,
+        fn(i, t [[maybe_unused]]) { result[i] = parent_[i].load(std::memory_order_relaxed); },
+        num_threads);
+    return result;
+  }
+
+private:
+  static constexpr std::size_t kParallelUnit = 1 << 14;
+
+  std::atomic<integral_t> count_;
+  std::vector<std::atomic<integral_t>> parent_;
+};
+}  // namespace bgl
@@ -2,6 +2,7 @@
 #include "bgl/util/all.hpp"
 #include <numeric>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace bgl {
@@ -12,22 +13,29 @@ public:
   using integral_t = T;
 
   /// class initialization: O(n)
-  union_find(integral_t count) : count_{count}, parent_(count), rank_(count) {
-    std::iota(parent_.begin(), parent_.end(), static_cast<integral_t>(0));
+  union_find(integral_t count) : count_{0} { extend(count); }
+
+  /// add singleton sets so that the number of elements becomes |count|: O(added elements)
+  void extend(integral_t count) {
+    if (count <= static_cast<integral_t>(parent_.size())) return;
+    integral_t first = parent_.size();
+    count_ += count - first;
+    parent_.resize(count);
+    size_.resize(count, 1);
+    std::iota(parent_.begin() + first, parent_.end(), first);
   }
 
-  /// merge sets that includes x and includes y: approximately O(1)
-  void unite(integral_t x, integral_t y) {
+  /// merge sets that includes x and includes y (union by size): approximately O(1)
+  /// @return true if they were different sets
+  bool unite(integral_t x, integral_t y) {
     x = find(x);
     y = find(y);
-    if (x == y) return;
-    if (rank_[x] < rank_[y]) {
-      parent_[x] = y;
-    } else {
-      parent_[y] = x;
-      if (rank_[x] == rank_[y]) ++rank_[x];
-    }
+    if (x == y) return false;
+    if (size_[x] < size_[y]) std::swap(x, y);
+    parent_[y] = x;
+    size_[x] += size_[y];
     --count_;
+    return true;
   }
 
   /// determine if x and y are included by the same set: approximately O(1)
@@ -36,6 +44,18 @@ public:
   /// return the number of disjoint sets: O(1)
   integral_t disjoint_count() { return count_; }
 
+  /// return the number of elements: O(1)
+  integral_t element_count() const { return parent_.size(); }
+
+  /// return the size of the set that includes x: approximately O(1)
+  integral_t set_size(integral_t x) { return size_[find(x)]; }
+
+  /// find representative ID: approximately O(1)
+  integral_t find(integral_t x) {
+    if (parent_[x] == x) return x;
+    return parent_[x] = find(parent_[x]);
+  }
+
   /// return list of component IDs
   std::vector<integral_t> components() {
     for (auto i : irange(parent_.size())) find(i);
@@ -45,12 +65,6 @@ public:
 private:
   integral_t count_;
   std::vector<integral_t> parent_;
-  std::vector<integral_t> rank_;
-
-  /// find representative ID
-  integral_t find(integral_t x) {
-    if (parent_[x] == x) return x;
-    return parent_[x] = find(parent_[x]);
-  }
+  std::vector<integral_t> size_;
 };
 }  // namespace bgl
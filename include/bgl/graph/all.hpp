@@ -1,7 +1,9 @@
 #pragma once
 
 #include "basic_graph.hpp"
+#include "csr_graph.hpp"
 #include "cui.hpp"
+#include "intersection.hpp"
 #include "io.hpp"
 #include "visitor.hpp"
 
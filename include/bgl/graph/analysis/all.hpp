@@ -1,7 +1,19 @@
 #pragma once
 
+#include "betweenness.hpp"
+#include "bfs.hpp"
+#include "closeness.hpp"
 #include "clustering_coefficient.hpp"
 #include "connectivity.hpp"
+#include "core_decomposition.hpp"
+#include "core_fringe_oracle.hpp"
+#include "delta_stepping.hpp"
 #include "hyperball.hpp"
+#include "incremental_connectivity.hpp"
 #include "minimum_degree.hpp"
+#include "multi_source_bfs.hpp"
+#include "pagerank.hpp"
+#include "point_to_point.hpp"
+#include "pruned_landmark_labeling.hpp"
 #include "slashburn.hpp"
+#include "triangle_counting.hpp"
@@ -0,0 +1,291 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace bgl {
+/// betweenness centrality of directed graph: the score of |v| is the sum of the fraction of
+/// shortest paths from |s| to |t| passing through |v| over all ordered pairs (|s|, |t|) with
+/// |s| != |v| != |t|. for undirected graphs, halve the scores to count unordered pairs.
+/// shortest paths are found by BFS on unweighted graphs and by Dijkstra on weighted graphs
+/// (weights must be positive).
+///   - exact scores are computed by Brandes' algorithm: sources are processed in parallel, and
+///     each thread accumulates dependencies to its own scores, which are summed at the end.
+///   - source sampling runs Brandes' algorithm from uniformly sampled sources and scales the
+///     scores: unbiased, and the error is small for nodes of high centrality.
+///   - path sampling draws uniformly random pairs (|s|, |t|) and a uniformly random shortest
+///     path between them. the number of samples is determined by the vertex diameter, so that
+///     all scores are within |epsilon| * n * (n - 1) of the exact ones with probability at
+///     least 1 - |delta|. each search stops when |t| is reached.
+/// @see "A faster algorithm for betweenness centrality"
+///      (U. Brandes). Journal of Mathematical Sociology, 2001.
+///      "Centrality estimation in large networks"
+///      (U. Brandes and C. Pich). International Journal of Bifurcation and Chaos, 2007.
+///      "Fast approximation of betweenness centrality through sampling"
+///      (M. Riondato and E. M. Kornaropoulos). In WSDM'14.
+template <typename GraphType>
+class betweenness_centrality {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename graph_type::weight_type;
+
+  /// @param g input graph
+  /// @param gt transposed graph of |g|
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  betweenness_centrality(const graph_type &g, const graph_type &gt, int num_threads = 0)
+      : g_{g},
+        gt_{gt},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        workspaces_(num_threads_) {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+  }
+
+  /// compute exact scores by Brandes' algorithm from all nodes: O(nm) for unweighted graphs
+  std::vector<double> exact() {
+    std::vector<node_t> sources(g_.num_nodes());
+    std::iota(sources.begin(), sources.end(), 0);
+    return brandes(sources, 1.0);
+  }
+
+  /// estimate scores by Brandes' algorithm from |num_sources| distinct sources sampled uniformly
+  /// at random, scaled by n / |num_sources|
+  std::vector<double> sample_sources(node_t num_sources) {
+    const node_t n = g_.num_nodes();
+    num_sources = std::min(num_sources, n);
+    if (num_sources == 0) return std::vector<double>(n);
+    std::vector<node_t> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    std::shuffle(sources.begin(), sources.end(), bgl_random);
+    sources.resize(num_sources);
+    std::sort(sources.begin(), sources.end());
+    return brandes(sources, static_cast<double>(n) / num_sources);
+  }
+
+  /// estimate scores by sampling shortest paths: with probability at least 1 - |delta|, all
+  /// scores are within |epsilon| * n * (n - 1) of the exact ones. the vertex diameter (the
+  /// maximum number of nodes in a shortest path) is bounded by twice the eccentricity for
+  /// unweighted undirected graphs, and by n otherwise. |num_samples| is the number of samples
+  std::vector<double> approximate(double epsilon, double delta = 0.1) {
+    ASSERT_MSG(epsilon > 0.0 && 0.0 < delta && delta < 1.0, "invalid parameters");
+    const node_t n = g_.num_nodes();
+    if (n < 3) return std::vector<double>(n);
+    const double vd = std::max<node_t>(3, vertex_diameter_bound());
+    const double bound = std::floor(std::log2(vd - 2)) + 1 + std::log(1.0 / delta);
+    num_samples_ = static_cast<std::size_t>(std::ceil(0.5 / (epsilon * epsilon) * bound));
+
+    prepare_workspaces();
+    const rng_t::result_type seed = bgl_random();
+    parallel_for(
+        num_samples_, kParallelUnit / 16,
+        fn(i, t) {
+          workspace &ws = workspaces_[t];
+          // a generator per sample keeps the result independent of the number of threads
+          rng_t rng(seed + i);
+          std::uniform_int_distribution<node_t> node_dist(0, n - 1);
+          const node_t s = node_dist(rng);
+          node_t target = node_dist(rng);
+          while (target == s) target = node_dist(rng);
+          search(s, target, ws);
+          if (ws.dist[target] != kInfinity) {
+            std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+            for (node_t w = predecessor(target, real_dist(rng), ws); w != s;
+                 w = predecessor(w, real_dist(rng), ws)) {
+              ws.scores[w] += 1.0;
+            }
+          }
+          reset(ws);
+        },
+        num_threads_);
+    return gather_scores(static_cast<double>(n) * (n - 1) / num_samples_);
+  }
+
+  /// return the number of samples of the last path sampling
+  std::size_t num_samples() const noexcept { return num_samples_; }
+
+private:
+  static constexpr std::size_t kParallelUnit = 1024;
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+  static constexpr bool kUnweighted = std::is_same_v<typename graph_type::edge_type,
+                                                     unweighted_edge_t>;
+
+  /// buffers of each thread: reset in time proportional to the touched nodes
+  struct workspace {
+    std::vector<weight_type> dist;
+    std::vector<double> sigma;  // the number of shortest paths
+    std::vector<double> delta;  // dependency of the source
+    std::vector<node_t> order;  // settled nodes in nondecreasing order of distance
+    std::vector<node_t> touched;
+    std::vector<double> scores;
+    std::optional<dijkstra_heap<graph_type>> heap;
+  };
+
+  const graph_type &g_;
+  const graph_type &gt_;
+  const int num_threads_;
+  std::vector<workspace> workspaces_;
+  std::size_t num_samples_ = 0;
+
+  void prepare_workspaces() {
+    const node_t n = g_.num_nodes();
+    parallel_for(
+        num_threads_, 1,
+        fn(i, t [[maybe_unused]]) {
+          workspace &ws = workspaces_[i];
+          if (ws.dist.size() != n) {
+            ws.dist.assign(n, kInfinity);
+            ws.sigma.assign(n, 0.0);
+            ws.delta.assign(n, 0.0);
+            if constexpr (!kUnweighted) ws.heap.emplace(g_);
+          }
+          ws.scores.assign(n, 0.0);
+        },
+        num_threads_);
+  }
+
+  std::vector<double> gather_scores(double scale) {
+    std::vector<double> result(g_.num_nodes());
+    parallel_for(
+        g_.num_nodes(), kParallelUnit * 16,
+        fn(v, t [[maybe_unused]]) {
+          double sum = 0.0;
+          for (const workspace &ws : workspaces_) sum += ws.scores[v];
+          result[v] = sum * scale;
+        },
+        num_threads_);
+    return result;
+  }
+
+  std::vector<double> brandes(const std::vector<node_t> &sources, double scale) {
+    prepare_workspaces();
+    parallel_for(
+        sources.size(), 1,
+        fn(i, t) {
+          workspace &ws = workspaces_[t];
+          const node_t s = sources[i];
+          search(s, kInvalidNode, ws);
+          // accumulate dependencies over out-edges in the shortest path DAG
+          for (std::size_t k = ws.order.size(); k-- > 0;) {
+            const node_t v = ws.order[k];
+            double dependency = 0.0;
+            for (const auto &e : g_.edges(v)) {
+              const node_t w = to(e);
+              if (ws.dist[w] != kInfinity && is_eq(ws.dist[v] + weight(e), ws.dist[w])) {
+                dependency += ws.sigma[v] / ws.sigma[w] * (1.0 + ws.delta[w]);
+              }
+            }
+            ws.delta[v] = dependency;
+            if (v != s) ws.scores[v] += dependency;
+          }
+          reset(ws);
+        },
+        num_threads_);
+    return gather_scores(scale);
+  }
+
+  /// compute distances and the numbers of shortest paths from |s|: when |target| is valid, stop
+  /// after settling |target|, where the values are exact for nodes closer than |target|
+  void search(node_t s, node_t target, workspace &ws) const {
+    ws.dist[s] = 0;
+    ws.sigma[s] = 1.0;
+    ws.touched.push_back(s);
+    if constexpr (kUnweighted) {
+      // |order| is the BFS queue
+      ws.order.push_back(s);
+      for (std::size_t i = 0; i < ws.order.size(); ++i) {
+        const node_t v = ws.order[i];
+        if (v == target) break;
+        for (node_t w : g_.neighbors(v)) {
+          if (ws.dist[w] == kInfinity) {
+            ws.dist[w] = ws.dist[v] + 1;
+            ws.order.push_back(w);
+            ws.touched.push_back(w);
+          }
+          if (ws.dist[w] == ws.dist[v] + 1) ws.sigma[w] += ws.sigma[v];
+        }
+      }
+    } else {
+      auto &heap = *ws.heap;
+      heap.decrease(s, 0);
+      while (!heap.empty()) {
+        const node_t v = heap.top_vertex();
+        heap.pop();
+        ws.order.push_back(v);
+        if (v == target) break;
+        for (const auto &e : g_.edges(v)) {
+          const node_t w = to(e);
+          const weight_type d = ws.dist[v] + weight(e);
+          if (ws.dist[w] == kInfinity) ws.touched.push_back(w);
+          if (is_lt(d, ws.dist[w])) {
+            ws.dist[w] = d;
+            ws.sigma[w] = ws.sigma[v];
+            heap.decrease(w, d);
+          } else if (is_eq(d, ws.dist[w])) {
+            ws.sigma[w] += ws.sigma[v];
+          }
+        }
+      }
+      heap.clear();
+    }
+  }
+
+  /// choose a predecessor of |w| in the shortest path DAG with probability proportional to its
+  /// number of shortest paths, where |r| is a uniform random number in [0, 1)
+  node_t predecessor(node_t w, double r, const workspace &ws) const {
+    double threshold = r * ws.sigma[w];
+    node_t last = kInvalidNode;
+    for (const auto &e : gt_.edges(w)) {
+      const node_t u = to(e);
+      if (ws.dist[u] == kInfinity || !is_eq(ws.dist[u] + weight(e), ws.dist[w])) continue;
+      last = u;
+      threshold -= ws.sigma[u];
+      if (threshold < 0.0) break;
+    }
+    return last;
+  }
+
+  void reset(workspace &ws) const {
+    for (node_t v : ws.touched) {
+      ws.dist[v] = kInfinity;
+      ws.sigma[v] = ws.delta[v] = 0.0;
+    }
+    ws.touched.clear();
+    ws.order.clear();
+  }
+
+  /// return an upper bound of the maximum number of nodes in a shortest path
+  node_t vertex_diameter_bound() {
+    const node_t n = g_.num_nodes();
+    if constexpr (!kUnweighted) {
+      return n;
+    } else {
+      for (node_t v : g_.nodes()) {
+        if (!std::equal(g_.neighbors(v).begin(), g_.neighbors(v).end(),
+                        gt_.neighbors(v).begin(), gt_.neighbors(v).end())) {
+          return n;
+        }
+      }
+      // undirected: a shortest path has at most 2 * eccentricity + 1 nodes in each component
+      prepare_workspaces();
+      workspace &ws = workspaces_[0];
+      std::vector<bool> visited(n);
+      node_t result = 1;
+      for (node_t v : g_.nodes()) {
+        if (visited[v]) continue;
+        search(v, kInvalidNode, ws);
+        for (node_t w : ws.order) visited[w] = true;
+        result = std::max<node_t>(result, 2 * ws.dist[ws.order.back()] + 1);
+        reset(ws);
+      }
+      return std::min(result, n);
+    }
+  }
+};
+}  // namespace bgl
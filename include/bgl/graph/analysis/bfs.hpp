@@ -0,0 +1,219 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace bgl {
+/// parallel direction-optimizing BFS on unweighted graph.
+/// top-down steps expand the frontier queue along out-edges, and bottom-up steps let each
+/// unvisited node look for a parent in the bitmap frontier along in-edges. bottom-up steps
+/// stop scanning in-edges at the first parent found, so they skip most edge checks when the
+/// frontier is large. buffers are reused across runs (e.g., BFS from many sources).
+/// @see "Direction-optimizing breadth-first search" (S. Beamer, K. Asanović and D. Patterson).
+///      In SC'12.
+template <typename GraphType>
+class direction_optimizing_bfs {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  static_assert(std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>,
+                "graph must be unweighted");
+
+  /// @param g input graph
+  /// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  direction_optimizing_bfs(const graph_type &g, const graph_type &gt, int num_threads = 0)
+      : g_{g},
+        gt_{gt},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        num_words_{(g.num_nodes() + std::size_t(63)) / 64},
+        distances_(g.num_nodes()),
+        visited_(num_words_),
+        front_(num_words_),
+        next_(num_words_),
+        local_queues_(num_threads_) {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+  }
+
+  /// run BFS from |source|. when |compute_parents|, parents in BFS tree are also computed
+  void run(node_t source, bool compute_parents = false) {
+    compute_parents_ = compute_parents;
+    std::fill(distances_.begin(), distances_.end(), kInfinity);
+    if (compute_parents_) {
+      parents_.assign(g_.num_nodes(), kInvalidNode);
+      parents_[source] = source;
+    }
+    for (auto &word : visited_) word.store(0, std::memory_order_relaxed);
+    visited_[source >> 6].store(bit(source), std::memory_order_relaxed);
+    distances_[source] = 0;
+    queue_.assign(1, source);
+
+    std::size_t edges_to_check = g_.num_edges();
+    std::size_t scout_count = g_.outdegree(source);
+    weight_type depth = 0;
+
+    while (!queue_.empty()) {
+      if (scout_count > edges_to_check / kAlpha) {
+        queue_to_bitmap();
+        std::size_t awake_count = queue_.size(), old_awake_count;
+        do {
+          old_awake_count = awake_count;
+          awake_count = bottom_up_step(++depth);
+          front_.swap(next_);
+        } while (awake_count >= old_awake_count || awake_count > g_.num_nodes() / kBeta);
+        bitmap_to_queue();
+        scout_count = 1;
+      } else {
+        edges_to_check -= std::min(edges_to_check, scout_count);
+        scout_count = top_down_step(++depth);
+      }
+    }
+  }
+
+  /// return distances from the source of the last run
+  /// (std::numeric_limits<weight_type>::max() when unreachable)
+  const std::vector<weight_type> &distances() const noexcept { return distances_; }
+
+  /// return parents in BFS tree of the last run with |compute_parents|
+  /// (parent of the source is itself, and that of unreachable node is |kInvalidNode|)
+  const std::vector<node_t> &parents() const noexcept { return parents_; }
+
+private:
+  using word_t = std::uint64_t;
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+  static constexpr std::size_t kAlpha = 15;  // switch to bottom-up when frontier has many edges
+  static constexpr std::size_t kBeta = 18;   // switch to top-down when frontier is small
+  static constexpr std::size_t kParallelUnit = 1024;
+  static constexpr std::size_t kParallelWordUnit = 64;
+
+  const graph_type &g_;
+  const graph_type &gt_;
+  const int num_threads_;
+  const std::size_t num_words_;
+  bool compute_parents_ = false;
+  std::vector<weight_type> distances_;
+  std::vector<node_t> parents_;
+  std::vector<std::atomic<word_t>> visited_;
+  std::vector<std::atomic<word_t>> front_;
+  std::vector<std::atomic<word_t>> next_;
+  std::vector<node_t> queue_;
+  std::vector<std::vector<node_t>> local_queues_;
+
+  static word_t bit(node_t v) noexcept { return word_t(1) << (v & 63); }
+
+  int threads_for(std::size_t n, std::size_t unit) const {
+    return std::max<int>(1, std::min<std::size_t>(num_threads_, (n + unit - 1) / unit));
+  }
+
+  /// expand frontier along out-edges: return the number of edges from the next frontier
+  std::size_t top_down_step(weight_type depth) {
+    std::atomic<std::size_t> scout_count = 0;
+    parallel_for(
+        queue_.size(), kParallelUnit,
+        fn(i, t) {
+          node_t u = queue_[i];
+          std::size_t local_scout_count = 0;
+          for (node_t v : g_.neighbors(u)) {
+            auto &word = visited_[v >> 6];
+            if (word.load(std::memory_order_relaxed) & bit(v)) continue;
+            if (word.fetch_or(bit(v), std::memory_order_relaxed) & bit(v)) continue;
+            distances_[v] = depth;
+            if (compute_parents_) parents_[v] = u;
+            local_queues_[t].push_back(v);
+            local_scout_count += g_.outdegree(v);
+          }
+          scout_count.fetch_add(local_scout_count, std::memory_order_relaxed);
+        },
+        threads_for(queue_.size(), kParallelUnit));
+    gather_local_queues();
+    return scout_count;
+  }
+
+  /// each unvisited node looks for a parent in frontier along in-edges:
+  /// return the number of nodes in the next frontier
+  std::size_t bottom_up_step(weight_type depth) {
+    std::atomic<std::size_t> awake_count = 0;
+    parallel_for(
+        num_words_, kParallelWordUnit,
+        fn(w, t [[maybe_unused]]) {
+          word_t visited = visited_[w].load(std::memory_order_relaxed);
+          word_t next = 0;
+          for (node_t v = w * 64; v < std::min<std::size_t>((w + 1) * 64, g_.num_nodes()); ++v) {
+            if (visited & bit(v)) continue;
+            for (node_t u : gt_.neighbors(v)) {
+              if (front_[u >> 6].load(std::memory_order_relaxed) & bit(u)) {
+                distances_[v] = depth;
+                if (compute_parents_) parents_[v] = u;
+                next |= bit(v);
+                break;
+              }
+            }
+          }
+          next_[w].store(next, std::memory_order_relaxed);
+          if (next != 0) {
+            visited_[w].store(visited | next, std::memory_order_relaxed);
+            awake_count.fetch_add(__builtin_popcountll(next), std::memory_order_relaxed);
+          }
+        },
+        threads_for(num_words_, kParallelWordUnit));
+    return awake_count;
+  }
+
+  void queue_to_bitmap() {
+    for (auto &word : front_) word.store(0, std::memory_order_relaxed);
+    parallel_for(
+        queue_.size(), kParallelUnit,
+        fn(i, t [[maybe_unused]]) {
+          node_t v = queue_[i];
+          front_[v >> 6].fetch_or(bit(v), std::memory_order_relaxed);
+        },
+        threads_for(queue_.size(), kParallelUnit));
+  }
+
+  void bitmap_to_queue() {
+    parallel_for(
+        num_words_, kParallelWordUnit,
+        fn(w, t) {
+          for (word_t word = front_[w].load(std::memory_order_relaxed); word != 0;
+               word &= word - 1) {
+            local_queues_[t].push_back(w * 64 + __builtin_ctzll(word));
+          }
+        },
+        threads_for(num_words_, kParallelWordUnit));
+    gather_local_queues();
+  }
+
+  /// move nodes in |local_queues_| to |queue_|
+  void gather_local_queues() {
+    std::vector<std::size_t> offsets(local_queues_.size() + 1);
+    for (std::size_t t : irange(local_queues_.size())) {
+      offsets[t + 1] = offsets[t] + local_queues_[t].size();
+    }
+    queue_.resize(offsets.back());
+    parallel_for(
+        local_queues_.size(), 1,
+        fn(t, i [[maybe_unused]]) {
+          std::copy(local_queues_[t].begin(), local_queues_[t].end(), queue_.begin() + offsets[t]);
+          local_queues_[t].clear();
+        },
+        threads_for(offsets.back(), kParallelUnit * 16));
+  }
+};
+
+/// compute single-source distances from |source| by parallel direction-optimizing BFS.
+/// unreachable nodes have distance std::numeric_limits<weight_type>::max()
+/// @param g input unweighted graph
+/// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<typename GraphType::weight_type> parallel_single_source_distance(
+    const GraphType &g, const GraphType &gt, node_t source, int num_threads = 0) {
+  direction_optimizing_bfs<GraphType> bfs(g, gt, num_threads);
+  bfs.run(source);
+  return bfs.distances();
+}
+}  // namespace bgl
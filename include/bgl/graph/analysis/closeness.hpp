@@ -0,0 +1,120 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// compute the |k| nodes of the highest normalized closeness centrality exactly by pruned BFS,
+/// where the normalized closeness of |v| is (n - 1) divided by the sum of distances from |v| to
+/// the other nodes, and 0 if some node is unreachable from |v| (pass the transposed graph for
+/// distances to |v|). note that |geometric_centralities::closeness| is instead the inverse of
+/// the sum of distances to the reachable nodes only.
+/// nodes are processed in decreasing order of outdegree in parallel, and each BFS stops as soon
+/// as a lower bound of the sum of distances exceeds the k-th smallest sum found so far: after
+/// visiting all nodes within distance |d|, the nodes found at distance |d| + 1 are counted as
+/// they are and the unvisited nodes are counted at distance |d| + 2.
+/// each thread keeps its own top-k candidates, and the cutoff is the minimum of their k-th sums.
+/// @see "Computing top-k closeness centrality faster in unweighted graphs"
+///      (E. Bergamini, M. Borassi, P. Crescenzi, A. Marino and H. Meyerhenke). In ALENEX'16.
+/// @param g input unweighted graph
+/// @param k the number of nodes to return
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @return pairs of node and normalized closeness in decreasing order of it (ties are broken by
+///         node ID)
+template <typename GraphType>
+std::vector<std::pair<node_t, double>> top_k_normalized_closeness(const GraphType &g, node_t k,
+                                                                  int num_threads = 0) {
+  static_assert(std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>,
+                "top_k_normalized_closeness only supports unweighted graphs");
+  constexpr std::uint64_t kInfinity = std::numeric_limits<std::uint64_t>::max();
+  const node_t n = g.num_nodes();
+  k = std::min(k, n);
+  if (k == 0) return {};
+  const int threads = num_threads > 0 ? num_threads : thread_pool::shared().size();
+
+  std::vector<node_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   fn(v, w) { return g.outdegree(v) > g.outdegree(w); });
+
+  // max-heaps of (sum of distances, node) of each thread
+  using candidate = std::pair<std::uint64_t, node_t>;
+  std::vector<std::priority_queue<candidate>> candidates(threads);
+  std::atomic<std::uint64_t> cutoff = kInfinity;
+
+  struct workspace {
+    std::vector<bool> visited;
+    std::vector<node_t> frontier, next, touched;
+  };
+  std::vector<workspace> workspaces(threads);
+
+  parallel_for(
+      n, 1,
+      fn(i, t) {
+        workspace &ws = workspaces[t];
+        if (ws.visited.size() != n) ws.visited.assign(n, false);
+        const node_t s = order[i];
+        ws.visited[s] = true;
+        ws.frontier.assign(1, s);
+        std::uint64_t sum = 0, num_visited = 1, d = 0;
+        ws.touched.assign(1, s);
+
+        while (!ws.frontier.empty()) {
+          ws.next.clear();
+          for (node_t v : ws.frontier) {
+            for (node_t w : g.neighbors(v)) {
+              if (ws.visited[w]) continue;
+              ws.visited[w] = true;
+              ws.next.push_back(w);
+            }
+          }
+          ws.touched.insert(ws.touched.end(), ws.next.begin(), ws.next.end());
+          const std::uint64_t num_next = ws.next.size();
+          if (num_next == 0) break;
+          const std::uint64_t bound =
+              sum + (d + 1) * num_next + (d + 2) * (n - num_visited - num_next);
+          if (bound > cutoff.load(std::memory_order_relaxed)) {
+            sum = kInfinity;
+            break;
+          }
+          sum += (d + 1) * num_next;
+          num_visited += num_next;
+          ++d;
+          std::swap(ws.frontier, ws.next);
+        }
+        if (num_visited < n) sum = kInfinity;
+        for (node_t v : ws.touched) ws.visited[v] = false;
+
+        auto &heap = candidates[t];
+        if (heap.size() < k) {
+          heap.emplace(sum, s);
+        } else if (candidate{sum, s} < heap.top()) {
+          heap.pop();
+          heap.emplace(sum, s);
+        }
+        if (heap.size() == k) atomic_fetch_min(cutoff, heap.top().first);
+      },
+      threads);
+
+  std::vector<candidate> merged;
+  for (auto &heap : candidates) {
+    for (; !heap.empty(); heap.pop()) merged.push_back(heap.top());
+  }
+  std::sort(merged.begin(), merged.end());
+  merged.resize(k);
+
+  std::vector<std::pair<node_t, double>> result;
+  for (auto [sum, v] : merged) {
+    result.emplace_back(v, sum == kInfinity || sum == 0 ? 0.0 : static_cast<double>(n - 1) / sum);
+  }
+  return result;
+}
+}  // namespace bgl
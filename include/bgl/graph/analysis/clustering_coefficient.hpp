@@ -1,28 +1,38 @@
 #pragma once
+#include "bgl/graph/analysis/triangle_counting.hpp"
 #include "bgl/graph/basic_graph.hpp"
 #include "bgl/util/all.hpp"
 
 namespace bgl {
-// compute clustering coefficient per degree up to |degree_threshold|: |g| must be undirected
-std::vector<double> clustering_coefficient_per_degree(const graph &g, node_t degree_threshold) {
-  std::vector<std::atomic<std::size_t>> count(degree_threshold + 1);
-  std::vector<std::atomic<std::size_t>> num_triangles(degree_threshold + 1);
+/// compute local clustering coefficient of each node, i.e., the fraction of pairs of neighbors
+/// that are adjacent (0.0 for nodes of degree less than 2): |g| must be undirected and simple
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<double> local_clustering_coefficient(const GraphType &g, int num_threads = 0) {
+  std::vector<std::uint64_t> num_triangles = count_triangles_per_node(g, num_threads);
+  std::vector<double> result(g.num_nodes());
+  parallel_for(
+      g.num_nodes(), 1 << 14,
+      fn(v, t [[maybe_unused]]) {
+        double d = g.outdegree(v);
+        result[v] = d < 2 ? 0.0 : 2.0 * num_triangles[v] / (d * (d - 1));
+      },
+      num_threads);
+  return result;
+}
 
-  g.for_each_node(fn(u, i [[maybe_unused]]) {
+// compute clustering coefficient per degree up to |degree_threshold|: |g| must be undirected
+inline std::vector<double> clustering_coefficient_per_degree(const graph &g,
+                                                             node_t degree_threshold) {
+  std::vector<std::uint64_t> num_triangles_per_node = count_triangles_per_node(g);
+  std::vector<std::size_t> count(degree_threshold + 1);
+  std::vector<std::uint64_t> num_triangles(degree_threshold + 1);
+  for (node_t u : g.nodes()) {
     std::size_t du = g.outdegree(u);
-    if (du > degree_threshold) return;
+    if (du > degree_threshold) continue;
     ++count[du];
-
-    for (std::size_t i : irange(du)) {
-      node_t v = g.neighbor(u, i);
-      for (std::size_t j : irange(i + 1, du)) {
-        node_t w = g.neighbor(u, j);
-        if (g.is_adjacent(v, w)) {
-          ++num_triangles[du];
-        }
-      }
-    }
-  });
+    num_triangles[du] += num_triangles_per_node[u];
+  }
 
   std::vector<double> result(degree_threshold + 1);
   for (node_t i : irange(degree_threshold + 1)) {
@@ -1,41 +1,124 @@
 #pragma once
-#include "bgl/data_structure/union_find.hpp"
+#include "bgl/data_structure/concurrent_union_find.hpp"
 #include "bgl/graph/visitor.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <stack>
-#include <unordered_map>
 
 namespace bgl {
-/// decompose graph into WCCs: nodes in the same components share the same ID
+/// decompose graph into WCCs in parallel by Afforest (see |weakly_connected_components|)
+/// @param g input graph
+/// @param gt transposed graph of |g|, |g| itself when undirected, or nullptr when unavailable
+/// @param num_threads the number of threads: when specified 0, set automatically
 /// @return pair of the number of components and list of component IDs
 template <typename GraphType>
-std::pair<node_t, std::vector<node_t>> weakly_connected_components(const GraphType &g) {
+std::pair<node_t, std::vector<node_t>> afforest_components(const GraphType &g,
+                                                           const GraphType *gt,
+                                                           int num_threads) {
+  constexpr std::size_t kNumSamples = 2;
+  constexpr node_t kNumRootSamples = 1024;
   const node_t n = g.num_nodes();
-  union_find<node_t> uf(n);
-  std::vector<bool> visited(n, false);
-  visitor_by_distance<GraphType> visitor(g);
+  concurrent_union_find<node_t> uf(n, num_threads);
+  for (std::size_t i : irange(kNumSamples)) {
+    g.for_each_node(
+        fn(v, t [[maybe_unused]]) {
+          if (i < g.outdegree(v)) uf.unite(v, g.neighbor(v, i));
+        },
+        num_threads);
+    uf.compress(num_threads);
+  }
 
-  for (node_t v : g.nodes()) {
-    visitor.visit(v, fn(w, d[[maybe_unused]]) {
-      uf.unite(v, w);
-      if (visited[w]) return false;
-      visited[w] = true;
-      return true;
-    });
+  // the most frequent root among evenly spaced nodes is likely the root of the largest component
+  node_t largest = kInvalidNode;
+  if (n > 0) {
+    const node_t num_root_samples = std::min(n, kNumRootSamples);
+    std::vector<node_t> roots;
+    for (node_t i : irange(num_root_samples)) {
+      roots.push_back(uf.find(static_cast<node_t>(std::uint64_t(i) * n / num_root_samples)));
+    }
+    std::sort(roots.begin(), roots.end());
+    std::size_t max_count = 0;
+    for (std::size_t i = 0, j = 0; i < roots.size(); i = j) {
+      while (j < roots.size() && roots[j] == roots[i]) ++j;
+      if (j - i > max_count) {
+        max_count = j - i;
+        largest = roots[i];
+      }
+    }
   }
 
+  // nodes in the largest component skip their remaining edges: an edge from such a node to
+  // another component is linked from the other end, by its out-edges or its in-edges in |gt|.
+  // without |gt|, nodes in the largest component still link edges leaving it
+  g.for_each_node(
+      fn(v, t [[maybe_unused]]) {
+        if (uf.find(v) == largest) {
+          if (gt == nullptr) {
+            for (std::size_t i = kNumSamples; i < g.outdegree(v); ++i) {
+              node_t w = g.neighbor(v, i);
+              if (uf.find(w) != largest) uf.unite(v, w);
+            }
+          }
+          return;
+        }
+        for (std::size_t i = kNumSamples; i < g.outdegree(v); ++i) uf.unite(v, g.neighbor(v, i));
+        if (gt != nullptr && gt != &g) {
+          for (node_t w : gt->neighbors(v)) uf.unite(v, w);
+        }
+      },
+      num_threads);
+
+  // roots are the smallest nodes of components, and precede other nodes in the components
+  std::vector<node_t> roots = uf.components(num_threads);
+  std::vector<node_t> ids(n);
   node_t num_components = 0;
-  std::vector<node_t> ids = uf.components();
-  std::unordered_map<node_t, node_t> id_map;
-  for (node_t &id : ids) {
-    if (id_map.count(id) == 0) {
-      id_map[id] = num_components++;
-    }
-    id = id_map[id];
+  for (node_t v : g.nodes()) {
+    if (roots[v] == v) ids[v] = num_components++;
   }
+  parallel_for(
+      n, 1 << 14,
+      fn(v, t [[maybe_unused]]) {
+        if (roots[v] != v) ids[v] = ids[roots[v]];
+      },
+      num_threads);
 
   return {num_components, ids};
 }
 
+/// decompose graph into WCCs in parallel: nodes in the same components share the same ID.
+/// component IDs are numbered in order of their smallest node.
+/// edges are merged by |concurrent_union_find|, whose representative is the smallest node
+/// (Afforest): first few edges of each node are merged and the forest is compressed, so that
+/// most of the remaining merges find the same root immediately. then the largest component
+/// is guessed by sampling roots, and its nodes only merge edges leaving it.
+/// finally, roots are numbered and the IDs are propagated by an array lookup.
+/// @see "Afforest: a fast concurrent link-based connected components algorithm"
+///      (M. Sutton, T. Ben-Nun and A. Barak). In IPDPS'18.
+/// @param g input graph
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @return pair of the number of components and list of component IDs
+template <typename GraphType>
+std::pair<node_t, std::vector<node_t>> weakly_connected_components(const GraphType &g,
+                                                                   int num_threads = 0) {
+  return afforest_components(g, static_cast<const GraphType *>(nullptr), num_threads);
+}
+
+/// decompose graph into WCCs in parallel (see above).
+/// with in-edges, nodes in the largest component skip their remaining edges entirely
+/// @param g input graph
+/// @param gt transposed graph of |g| (or |g| itself when |g| is undirected)
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @return pair of the number of components and list of component IDs
+template <typename GraphType>
+std::pair<node_t, std::vector<node_t>> weakly_connected_components(const GraphType &g,
+                                                                   const GraphType &gt,
+                                                                   int num_threads = 0) {
+  ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+  return afforest_components(g, &gt, num_threads);
+}
+
 /// [destructive] extract largest WCC
 template <typename GraphType>
 GraphType &extract_largest_wcc(GraphType &g) {
@@ -121,10 +204,279 @@ std::pair<node_t, std::vector<node_t>> strongly_connected_components(const Graph
   return {index, ids};
 }
 
-/// [destructive] extract largest SCC
+/// parallel SCC decomposition by Multistep algorithm.
+///   1. trimming: nodes without in-edges or out-edges are SCCs by themselves, and removing them
+///      may make other nodes trimmable. this removes the bulk of trivial SCCs in web graphs.
+///   2. forward-backward: nodes reachable from and to a pivot of large degree form an SCC,
+///      which is usually the giant SCC.
+///   3. coloring: each node gets the largest ID of nodes that can reach it, and nodes that can
+///      reach the node of their color with the same color form an SCC. repeated until only a
+///      few nodes remain, which are finished by sequential Tarjan's algorithm.
+/// every step is a parallel loop or a level-synchronous parallel search.
+/// @see "BFS and coloring-based parallel algorithms for strongly connected components and
+///      related problems" (G. M. Slota, S. Rajamanickam and K. Madduri). In IPDPS'14.
 template <typename GraphType>
-GraphType &extract_largest_scc(GraphType &g) {
-  auto [num_components, ids] = strongly_connected_components(g);
+class multistep_scc {
+public:
+  using graph_type = GraphType;
+
+  /// @param g input graph
+  /// @param gt transposed graph of |g|
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  multistep_scc(const graph_type &g, const graph_type &gt, int num_threads = 0)
+      : g_{g},
+        gt_{gt},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        reps_(g.num_nodes()),
+        colors_(g.num_nodes()),
+        queued_(g.num_nodes()),
+        local_queues_(num_threads_) {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+  }
+
+  /// decompose graph into SCCs: component IDs are numbered in order of their smallest node
+  /// (partition is the same as |strongly_connected_components|)
+  /// @return pair of the number of components and list of component IDs
+  std::pair<node_t, std::vector<node_t>> run() {
+    parallel_for(
+        g_.num_nodes(), kParallelUnit * 16,
+        fn(v, t [[maybe_unused]]) {
+          reps_[v].store(kInvalidNode, std::memory_order_relaxed);
+          colors_[v].store(kInvalidNode, std::memory_order_relaxed);
+          queued_[v].store(false, std::memory_order_relaxed);
+        },
+        num_threads_);
+
+    trim();
+    forward_backward();
+    collect_active();
+    while (!active_.empty()) {
+      if (active_.size() < kSequentialThreshold) {
+        run_tarjan();
+        break;
+      }
+      coloring();
+      collect_active();
+    }
+    return relabel();
+  }
+
+private:
+  static constexpr std::size_t kParallelUnit = 1024;
+  static constexpr std::size_t kSequentialThreshold = 1 << 14;
+
+  const graph_type &g_;
+  const graph_type &gt_;
+  const int num_threads_;
+  std::vector<std::atomic<node_t>> reps_;  // representative of SCC (|kInvalidNode| if active)
+  std::vector<std::atomic<node_t>> colors_;
+  std::vector<std::atomic<bool>> queued_;
+  std::vector<node_t> active_;
+  std::vector<node_t> frontier_;
+  std::vector<std::vector<node_t>> local_queues_;
+
+  int threads_for(std::size_t n) const {
+    return std::max<int>(1, std::min<std::size_t>(num_threads_, n / kParallelUnit + 1));
+  }
+
+  bool is_active(node_t v) const {
+    return reps_[v].load(std::memory_order_relaxed) == kInvalidNode;
+  }
+
+  /// assign |rep| to active node |v|: return false if |v| is already assigned
+  bool assign(node_t v, node_t rep) {
+    node_t expected = kInvalidNode;
+    return reps_[v].compare_exchange_strong(expected, rep, std::memory_order_relaxed);
+  }
+
+  /// move nodes in |local_queues_| to |nodes|
+  void gather(std::vector<node_t> &nodes) {
+    nodes.clear();
+    for (auto &queue : local_queues_) {
+      nodes.insert(nodes.end(), queue.begin(), queue.end());
+      queue.clear();
+    }
+  }
+
+  /// level-synchronous parallel search on |h| from |frontier_|:
+  /// |visit(u, w)| is called for each edge (u, w) and returns true when |w| is newly visited
+  template <typename Visit>
+  void search(const graph_type &h, Visit visit) {
+    while (!frontier_.empty()) {
+      parallel_for(
+          frontier_.size(), kParallelUnit / 16,
+          fn(i, t) {
+            node_t u = frontier_[i];
+            for (node_t w : h.neighbors(u)) {
+              if (visit(u, w)) local_queues_[t].push_back(w);
+            }
+          },
+          threads_for(frontier_.size()));
+      gather(frontier_);
+    }
+  }
+
+  /// remove nodes without in-edges or out-edges from active nodes repeatedly
+  void trim() {
+    std::vector<std::atomic<std::uint32_t>> outdegrees(g_.num_nodes()), indegrees(g_.num_nodes());
+    g_.for_each_node(
+        fn(v, t) {
+          std::uint32_t outdegree = 0, indegree = 0;
+          for (node_t w : g_.neighbors(v)) outdegree += w != v;
+          for (node_t w : gt_.neighbors(v)) indegree += w != v;
+          outdegrees[v].store(outdegree, std::memory_order_relaxed);
+          indegrees[v].store(indegree, std::memory_order_relaxed);
+          if ((outdegree == 0 || indegree == 0) && assign(v, v)) local_queues_[t].push_back(v);
+        },
+        num_threads_);
+    gather(frontier_);
+
+    // removing |u| decrements degrees of its neighbors
+    auto visit_out = fn(u, w) {
+      return w != u && indegrees[w].fetch_sub(1, std::memory_order_relaxed) == 1 && assign(w, w);
+    };
+    auto visit_in = fn(u, w) {
+      return w != u && outdegrees[w].fetch_sub(1, std::memory_order_relaxed) == 1 && assign(w, w);
+    };
+    while (!frontier_.empty()) {
+      parallel_for(
+          frontier_.size(), kParallelUnit / 16,
+          fn(i, t) {
+            node_t u = frontier_[i];
+            for (node_t w : g_.neighbors(u)) {
+              if (visit_out(u, w)) local_queues_[t].push_back(w);
+            }
+            for (node_t w : gt_.neighbors(u)) {
+              if (visit_in(u, w)) local_queues_[t].push_back(w);
+            }
+          },
+          threads_for(frontier_.size()));
+      gather(frontier_);
+    }
+  }
+
+  /// extract SCC of the active node with the largest product of outdegree and indegree
+  void forward_backward() {
+    node_t pivot = kInvalidNode;
+    std::size_t max_product = 0;
+    for (node_t v : g_.nodes()) {
+      std::size_t product = g_.outdegree(v) * gt_.outdegree(v);
+      if (is_active(v) && (pivot == kInvalidNode || product > max_product)) {
+        pivot = v;
+        max_product = product;
+      }
+    }
+    if (pivot == kInvalidNode) return;
+
+    // nodes reachable from |pivot| are marked by color |pivot|
+    colors_[pivot].store(pivot, std::memory_order_relaxed);
+    frontier_.assign(1, pivot);
+    search(g_, fn(u [[maybe_unused]], w) {
+      return is_active(w) && colors_[w].exchange(pivot, std::memory_order_relaxed) != pivot;
+    });
+
+    assign(pivot, pivot);
+    frontier_.assign(1, pivot);
+    search(gt_, fn(u [[maybe_unused]], w) {
+      return colors_[w].load(std::memory_order_relaxed) == pivot && assign(w, pivot);
+    });
+  }
+
+  /// collect active nodes into |active_|
+  void collect_active() {
+    parallel_for(
+        g_.num_nodes(), kParallelUnit * 16,
+        fn(v, t) {
+          if (is_active(v)) local_queues_[t].push_back(v);
+        },
+        threads_for(g_.num_nodes() / 16));
+    gather(active_);
+  }
+
+  /// extract SCCs of the nodes whose color is the largest ID of nodes that can reach them
+  void coloring() {
+    parallel_for(
+        active_.size(), kParallelUnit * 16,
+        fn(i, t [[maybe_unused]]) {
+          colors_[active_[i]].store(active_[i], std::memory_order_relaxed);
+          queued_[active_[i]].store(true, std::memory_order_relaxed);
+        },
+        threads_for(active_.size() / 16));
+
+    // propagate colors along out-edges only from nodes whose color has been updated
+    frontier_ = active_;
+    while (!frontier_.empty()) {
+      parallel_for(
+          frontier_.size(), kParallelUnit / 16,
+          fn(i, t) {
+            node_t u = frontier_[i];
+            // acquire-release pairs with the exchange below: if another thread has raised the
+            // color of |u| but seen |u| still queued, the raised color is loaded here
+            queued_[u].exchange(false, std::memory_order_acq_rel);
+            node_t color = colors_[u].load(std::memory_order_relaxed);
+            for (node_t w : g_.neighbors(u)) {
+              if (is_active(w) && atomic_fetch_max(colors_[w], color) &&
+                  !queued_[w].exchange(true, std::memory_order_acq_rel)) {
+                local_queues_[t].push_back(w);
+              }
+            }
+          },
+          threads_for(frontier_.size()));
+      gather(frontier_);
+    }
+
+    // backward search from the node of each color within the same color
+    for (node_t v : active_) {
+      if (colors_[v].load(std::memory_order_relaxed) == v) frontier_.push_back(v);
+    }
+    for (node_t v : frontier_) assign(v, v);
+    search(gt_, fn(u, w) {
+      node_t color = colors_[u].load(std::memory_order_relaxed);
+      return colors_[w].load(std::memory_order_relaxed) == color && assign(w, color);
+    });
+  }
+
+  /// decompose the subgraph induced by |active_| by Tarjan's algorithm
+  void run_tarjan() {
+    // index in |active_| is stored in |colors_|
+    for (node_t i : irange(active_.size())) {
+      colors_[active_[i]].store(i, std::memory_order_relaxed);
+    }
+    unweighted_adjacency_list adj(active_.size());
+    for (node_t i : irange(active_.size())) {
+      for (node_t w : g_.neighbors(active_[i])) {
+        if (is_active(w)) adj[i].push_back(colors_[w].load(std::memory_order_relaxed));
+      }
+    }
+
+    auto [num_components, ids] = strongly_connected_components(graph(std::move(adj)));
+    std::vector<node_t> reps(num_components, kInvalidNode);
+    for (node_t i : irange(active_.size())) {
+      if (reps[ids[i]] == kInvalidNode) reps[ids[i]] = active_[i];
+      reps_[active_[i]].store(reps[ids[i]], std::memory_order_relaxed);
+    }
+  }
+
+  /// number components in order of their smallest node
+  std::pair<node_t, std::vector<node_t>> relabel() {
+    node_t num_components = 0;
+    std::vector<node_t> ids(g_.num_nodes());
+    std::vector<node_t> id_of_rep(g_.num_nodes(), kInvalidNode);
+    for (node_t v : g_.nodes()) {
+      node_t rep = reps_[v].load(std::memory_order_relaxed);
+      if (id_of_rep[rep] == kInvalidNode) id_of_rep[rep] = num_components++;
+      ids[v] = id_of_rep[rep];
+    }
+    return {num_components, ids};
+  }
+};
+
+/// [destructive] keep only the largest component of |g|.
+/// component IDs are assumed to be numbered in order of their smallest node, so that the
+/// component containing the smallest node wins a tie of sizes
+template <typename GraphType>
+GraphType &filter_largest_component(GraphType &g, node_t num_components,
+                                    const std::vector<node_t> &ids) {
   std::vector<node_t> num_nodes(num_components);
   for (node_t id : ids) {
     num_nodes[id]++;
@@ -139,6 +491,36 @@ GraphType &extract_largest_scc(GraphType &g) {
   return g.filter_nodes(filter_list);
 }
 
+/// decompose graph into SCCs in parallel (see |multistep_scc|)
+/// @param g input graph
+/// @param gt transposed graph of |g|
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @return pair of the number of components and list of component IDs
+template <typename GraphType>
+std::pair<node_t, std::vector<node_t>> parallel_strongly_connected_components(
+    const GraphType &g, const GraphType &gt, int num_threads = 0) {
+  return multistep_scc<GraphType>(g, gt, num_threads).run();
+}
+
+/// [destructive] extract largest SCC, decomposed in parallel (see |multistep_scc|).
+/// when multiple SCCs have the largest size, the one containing the smallest node is extracted
+/// @param g input graph
+/// @param gt transposed graph of |g|
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+GraphType &extract_largest_scc(GraphType &g, const GraphType &gt, int num_threads = 0) {
+  auto [num_components, ids] = parallel_strongly_connected_components(g, gt, num_threads);
+  return filter_largest_component(g, num_components, ids);
+}
+
+/// [destructive] extract largest SCC (see above).
+/// transposed graph of |g| is built temporarily and released before nodes are filtered
+template <typename GraphType>
+GraphType &extract_largest_scc(GraphType &g) {
+  auto [num_components, ids] = parallel_strongly_connected_components(g, g.transposed());
+  return filter_largest_component(g, num_components, ids);
+}
+
 /// determine if graph is strongly connected
 template <typename GraphType>
 bool is_strongly_connected(const GraphType &g) {
@@ -0,0 +1,132 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// k-core decomposition of undirected graph by parallel peeling (self loops are ignored).
+/// for each level k (skipping to the minimum degree of remaining nodes), nodes of degree k are
+/// removed in rounds: removing a round decrements degrees of neighbors atomically, and the
+/// neighbors whose degree drops to k form the next round. remaining nodes are compacted after
+/// each level, so each level costs the number of remaining nodes plus the removed edges.
+/// the degeneracy ordering is the concatenation of the rounds (each sorted by ID): every node has
+/// at most its core number of neighbors after itself.
+/// @see "Parallel k-core decomposition on multicore platforms"
+///      (H. Kabir and K. Madduri). In IPDPSW'17.
+/// @param g input undirected graph
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @return pair of core numbers and degeneracy ordering
+template <typename GraphType>
+std::pair<std::vector<node_t>, std::vector<node_t>> core_decomposition(const GraphType &g,
+                                                                       int num_threads = 0) {
+  constexpr std::size_t kParallelUnit = 1024;
+  const node_t n = g.num_nodes();
+  const int threads = num_threads > 0 ? num_threads : thread_pool::shared().size();
+  std::vector<std::atomic<node_t>> degrees(n);
+  std::vector<node_t> cores(n, kInvalidNode);
+  std::vector<node_t> order;
+  std::vector<std::vector<node_t>> local_queues(threads);
+  auto gather = [&](std::vector<node_t> &nodes) {
+    nodes.clear();
+    for (auto &queue : local_queues) {
+      nodes.insert(nodes.end(), queue.begin(), queue.end());
+      queue.clear();
+    }
+  };
+
+  g.for_each_node(
+      fn(v, t) {
+        node_t degree = 0;
+        for (node_t w : g.neighbors(v)) degree += w != v;
+        degrees[v].store(degree, std::memory_order_relaxed);
+        local_queues[t].push_back(v);
+      },
+      threads);
+  std::vector<node_t> remaining, frontier;
+  gather(remaining);
+
+  for (node_t k = 0; !remaining.empty(); ++k) {
+    std::vector<node_t> min_degrees(threads, kInvalidNode);
+    parallel_for(
+        remaining.size(), kParallelUnit * 16,
+        fn(i, t) {
+          node_t d = degrees[remaining[i]].load(std::memory_order_relaxed);
+          min_degrees[t] = std::min(min_degrees[t], d);
+        },
+        threads);
+    k = std::max(k, *std::min_element(min_degrees.begin(), min_degrees.end()));
+
+    parallel_for(
+        remaining.size(), kParallelUnit * 16,
+        fn(i, t) {
+          if (degrees[remaining[i]].load(std::memory_order_relaxed) == k) {
+            local_queues[t].push_back(remaining[i]);
+          }
+        },
+        threads);
+    gather(frontier);
+
+    while (!frontier.empty()) {
+      std::sort(frontier.begin(), frontier.end());
+      for (node_t v : frontier) cores[v] = k;
+      order.insert(order.end(), frontier.begin(), frontier.end());
+      parallel_for(
+          frontier.size(), kParallelUnit / 16,
+          fn(i, t) {
+            node_t v = frontier[i];
+            for (node_t w : g.neighbors(v)) {
+              if (w == v || degrees[w].load(std::memory_order_relaxed) <= k) continue;
+              node_t old = degrees[w].fetch_sub(1, std::memory_order_relaxed);
+              if (old == k + 1) {
+                local_queues[t].push_back(w);
+              } else if (old <= k) {
+                // another thread has already decremented it to k
+                degrees[w].fetch_add(1, std::memory_order_relaxed);
+              }
+            }
+          },
+          threads);
+      gather(frontier);
+    }
+
+    parallel_for(
+        remaining.size(), kParallelUnit * 16,
+        fn(i, t) {
+          if (cores[remaining[i]] == kInvalidNode) local_queues[t].push_back(remaining[i]);
+        },
+        threads);
+    gather(remaining);
+  }
+
+  return {cores, order};
+}
+
+/// compute core number of each node of undirected graph |g| (see |core_decomposition|)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<node_t> core_numbers(const GraphType &g, int num_threads = 0) {
+  return core_decomposition(g, num_threads).first;
+}
+
+/// compute degeneracy ordering of undirected graph |g| (see |core_decomposition|)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<node_t> degeneracy_ordering(const GraphType &g, int num_threads = 0) {
+  return core_decomposition(g, num_threads).second;
+}
+
+/// [destructive] extract k-core (maximal subgraph whose minimum degree is at least |k|)
+template <typename GraphType>
+GraphType &extract_k_core(GraphType &g, node_t k) {
+  std::vector<node_t> cores = core_numbers(g);
+  std::vector<bool> filter_list(g.num_nodes());
+  for (node_t v : g.nodes()) {
+    filter_list[v] = cores[v] >= k;
+  }
+
+  return g.filter_nodes(filter_list);
+}
+}  // namespace bgl
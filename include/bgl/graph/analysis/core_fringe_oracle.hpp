@@ -0,0 +1,221 @@
+#pragma once
+#include "bgl/graph/analysis/minimum_degree.hpp"
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// exact distance oracle on undirected graph by core-fringe decomposition.
+/// nodes are eliminated in minimum-degree order by |min_degree_eliminator| while the degree is
+/// at most |max_width|: eliminated nodes form the fringe (a tree decomposition of low width),
+/// and the others form the core. eliminating a node connects its remaining neighbors by
+/// shortcuts, so the core graph keeps distances between core nodes.
+/// each node is labeled with distances to the nodes above it in the tree decomposition
+/// (including core nodes where its tree is attached), computed top-down from the bags.
+/// a query merges two labels for paths within the fringe, and runs Dijkstra on the core graph
+/// from the core entries of one label to those of the other for paths through the core.
+/// buffers are reset in time proportional to the explored region, so the object should be
+/// reused across queries.
+/// @see "Shortest-path queries for complex networks: exploiting low tree-width outside the core"
+///      (T. Akiba, C. Sommer and K. Kawarabayashi). In EDBT'12.
+template <typename GraphType>
+class core_fringe_oracle {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  using core_graph_type = wgraph<weight_type>;
+  static_assert(std::is_arithmetic_v<weight_type>, "edge weight must be arithmetic type");
+
+  /// @param g input undirected graph (weights must be non-negative)
+  /// @param max_width maximum degree of eliminated nodes (i.e., width of tree decomposition)
+  core_fringe_oracle(const graph_type &g, int max_width) : rank_(g.num_nodes()) {
+    // elimination ordering on the structure of |g|
+    unweighted_adjacency_list skeleton(g.num_nodes());
+    for (node_t v : g.nodes()) {
+      for (node_t w : g.neighbors(v)) skeleton[v].push_back(w);
+    }
+    graph structure(std::move(skeleton));
+    structure.simplify();
+    min_degree_eliminator eliminator(std::move(structure), max_width);
+    order_ = eliminator.ordering();
+    num_fringe_nodes_ = eliminator.width_ends().back();
+    for (node_t i : irange(g.num_nodes())) rank_[order_[i]] = i;
+
+    auto bags = eliminate(g);
+    build_labels(bags);
+    heap_.emplace(core_);
+    core_targets_.assign(core_.num_nodes(), kInfinity);
+  }
+
+  /// return distance between |s| and |t| (std::numeric_limits<weight_type>::max() when
+  /// unreachable)
+  weight_type query(node_t s, node_t t) {
+    const std::uint64_t s_end = offsets_[s + 1], t_end = offsets_[t + 1];
+    std::uint64_t i = offsets_[s], j = offsets_[t];
+    weight_type result = kInfinity;
+
+    // common nodes above both in tree decomposition
+    while (i < s_end && j < t_end) {
+      if (label_ranks_[i] < label_ranks_[j]) {
+        ++i;
+      } else if (label_ranks_[i] > label_ranks_[j]) {
+        ++j;
+      } else {
+        result = std::min<weight_type>(result, label_distances_[i++] + label_distances_[j++]);
+      }
+    }
+
+    // paths through core: core entries are at the end of labels
+    i = core_entries_begin(s);
+    j = core_entries_begin(t);
+    if (i == s_end || j == t_end) return result;
+    for (; j < t_end; ++j) {
+      node_t c = label_ranks_[j] - num_fringe_nodes_;
+      core_targets_[c] = label_distances_[j];
+      touched_.push_back(c);
+    }
+    for (; i < s_end; ++i) {
+      heap_->decrease(label_ranks_[i] - num_fringe_nodes_, label_distances_[i]);
+    }
+    while (!heap_->empty()) {
+      node_t v = heap_->top_vertex();
+      weight_type d = heap_->top_weight();
+      if (d >= result) break;
+      heap_->pop();
+      if (core_targets_[v] != kInfinity) {
+        result = std::min<weight_type>(result, d + core_targets_[v]);
+      }
+      for (const auto &e : core_.edges(v)) heap_->decrease(to(e), d + weight(e));
+    }
+
+    heap_->clear();
+    for (node_t c : touched_) core_targets_[c] = kInfinity;
+    touched_.clear();
+    return result;
+  }
+
+  /// return the number of nodes in the fringe (eliminated nodes)
+  node_t num_fringe_nodes() const noexcept { return num_fringe_nodes_; }
+
+  /// return core graph (node |i| of core graph is |core_node(i)|)
+  const core_graph_type &core_graph() const noexcept { return core_; }
+
+  /// return original ID of node |i| of core graph
+  node_t core_node(node_t i) const noexcept { return order_[num_fringe_nodes_ + i]; }
+
+  /// return the total number of label entries
+  std::size_t num_label_entries() const noexcept { return label_ranks_.size(); }
+
+private:
+  using entry_t = std::pair<node_t, weight_type>;
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+
+  std::vector<node_t> order_;
+  std::vector<node_t> rank_;  // position in |order_|: fringe nodes come first
+  node_t num_fringe_nodes_ = 0;
+  // labels: entries of node v are [offsets_[v], offsets_[v + 1]), sorted by rank
+  std::vector<std::uint64_t> offsets_;
+  std::vector<node_t> label_ranks_;
+  std::vector<weight_type> label_distances_;
+  core_graph_type core_;
+  std::optional<dijkstra_heap<core_graph_type>> heap_;
+  std::vector<weight_type> core_targets_;
+  std::vector<node_t> touched_;
+
+  std::uint64_t core_entries_begin(node_t v) const {
+    auto first = label_ranks_.begin() + offsets_[v], last = label_ranks_.begin() + offsets_[v + 1];
+    return std::lower_bound(first, last, num_fringe_nodes_) - label_ranks_.begin();
+  }
+
+  /// sort |es| by node and keep the lightest edge to each node not in |eliminated|
+  static void compact(std::vector<entry_t> &es, const std::vector<bool> &eliminated) {
+    remove_elements_if(es, fn(e) { return eliminated[e.first]; });
+    std::sort(es.begin(), es.end());
+    es.erase(std::unique(es.begin(), es.end(), fn(x, y) { return x.first == y.first; }),
+             es.end());
+  }
+
+  /// eliminate fringe nodes with shortcuts: return bags (remaining neighbors with distances)
+  /// of fringe nodes, and build core graph from the remaining edges
+  std::vector<std::vector<entry_t>> eliminate(const graph_type &g) {
+    std::vector<std::vector<entry_t>> adj(g.num_nodes());
+    std::vector<std::size_t> compacted_sizes(g.num_nodes());
+    for (node_t v : g.nodes()) {
+      for (const auto &e : g.edges(v)) {
+        if (to(e) != v) adj[v].emplace_back(to(e), weight(e));
+      }
+    }
+
+    std::vector<bool> eliminated(g.num_nodes(), false);
+    std::vector<std::vector<entry_t>> bags(num_fringe_nodes_);
+    for (node_t i : irange(num_fringe_nodes_)) {
+      node_t v = order_[i];
+      compact(adj[v], eliminated);
+      eliminated[v] = true;
+      bags[i].swap(adj[v]);
+      for (auto [a, wa] : bags[i]) {
+        for (auto [b, wb] : bags[i]) {
+          if (a != b) adj[a].emplace_back(b, wa + wb);
+        }
+        // shortcuts are appended lazily, so compact the list when it grows twice
+        if (adj[a].size() > 2 * compacted_sizes[a] + 16) {
+          compact(adj[a], eliminated);
+          compacted_sizes[a] = adj[a].size();
+        }
+      }
+    }
+
+    weighted_edge_list<weight_type> es;
+    for (node_t i : irange(num_fringe_nodes_, node_t(g.num_nodes()))) {
+      node_t v = order_[i];
+      compact(adj[v], eliminated);
+      for (auto [w, d] : adj[v]) {
+        es.emplace_back(i - num_fringe_nodes_, entry_t{rank_[w] - num_fringe_nodes_, d});
+      }
+    }
+    core_.assign(g.num_nodes() - num_fringe_nodes_, es);
+    return bags;
+  }
+
+  /// compute labels top-down: label of fringe node v is itself and nodes in the labels of its bag
+  /// with distances relaxed through v's bag, and label of core node is itself
+  void build_labels(const std::vector<std::vector<entry_t>> &bags) {
+    const node_t n = order_.size();
+    std::vector<std::vector<entry_t>> labels(n);  // indexed by rank
+    for (node_t i : irange(num_fringe_nodes_, n)) labels[i].emplace_back(i, 0);
+
+    std::vector<weight_type> tmp(n, kInfinity);
+    std::vector<node_t> touched;
+    for (node_t i = num_fringe_nodes_; i-- > 0;) {
+      touched.assign(1, i);
+      tmp[i] = 0;
+      for (auto [x, wx] : bags[i]) {
+        for (auto [r, d] : labels[rank_[x]]) {
+          if (tmp[r] == kInfinity) touched.push_back(r);
+          tmp[r] = std::min<weight_type>(tmp[r], wx + d);
+        }
+      }
+      std::sort(touched.begin(), touched.end());
+      for (node_t r : touched) {
+        labels[i].emplace_back(r, tmp[r]);
+        tmp[r] = kInfinity;
+      }
+    }
+
+    offsets_.assign(1, 0);
+    for (node_t v : irange(n)) offsets_.push_back(offsets_.back() + labels[rank_[v]].size());
+    for (node_t v : irange(n)) {
+      for (auto [r, d] : labels[rank_[v]]) {
+        label_ranks_.push_back(r);
+        label_distances_.push_back(d);
+      }
+    }
+  }
+};
+}  // namespace bgl
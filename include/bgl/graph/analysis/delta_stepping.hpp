@@ -0,0 +1,211 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace bgl {
+/// parallel single-source shortest paths by delta-stepping on graph with non-negative weights.
+/// nodes are kept in buckets of width |delta| by tentative distance, and buckets are processed
+/// in increasing order: nodes of the current bucket relax their light edges (weight < |delta|)
+/// in parallel until the bucket becomes empty, and then nodes settled in the bucket relax their
+/// heavy edges once. each thread has its own buckets, so no locks are needed.
+/// tentative distances in buckets never exceed those of the current bucket by more than the
+/// maximum edge weight, so buckets are kept in a cyclic array of about (max weight) / |delta|
+/// buckets, independent of the maximum distance.
+/// buffers are reused across runs (e.g., shortest paths from many sources).
+/// @see "Delta-stepping: a parallelizable shortest path algorithm"
+///      (U. Meyer and P. Sanders). Journal of Algorithms, 2003.
+template <typename GraphType>
+class delta_stepping {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  static_assert(std::is_arithmetic_v<weight_type>, "edge weight must be arithmetic type");
+
+  /// @param g input graph (weights must be non-negative)
+  /// @param delta width of buckets: when specified 0, set to the average edge weight
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  delta_stepping(const graph_type &g, weight_type delta = 0, int num_threads = 0)
+      : g_{g},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        delta_{delta > 0 ? delta : default_delta(g)},
+        num_buckets_{num_cyclic_buckets(g, delta_)},
+        distances_(g.num_nodes()),
+        settled_bucket_(g.num_nodes()),
+        local_buckets_(num_threads_),
+        local_settled_(num_threads_) {}
+
+  /// return width of buckets
+  weight_type delta() const noexcept { return delta_; }
+
+  /// compute distances from |source|
+  void run(node_t source) {
+    parallel_for(
+        g_.num_nodes(), kParallelUnit * 16,
+        fn(v, t [[maybe_unused]]) {
+          distances_[v].store(kInfinity, std::memory_order_relaxed);
+          settled_bucket_[v].store(kNoBucket, std::memory_order_relaxed);
+        },
+        num_threads_);
+    for (auto &buckets : local_buckets_) buckets.clear();
+    distances_[source] = 0;
+    local_buckets_[0].assign(1, {source});
+
+    for (std::size_t bucket = 0; bucket != kNoBucket; bucket = next_bucket(bucket)) {
+      // relax light edges until current bucket becomes empty
+      gather(frontier_, fn(t) { return take_bucket(t, bucket); });
+      while (!frontier_.empty()) {
+        relax(frontier_, true, bucket);
+        gather(frontier_, fn(t) { return take_bucket(t, bucket); });
+      }
+
+      // distances of nodes settled in current bucket are final
+      gather(settled_, fn(t) {
+        std::vector<node_t> nodes;
+        nodes.swap(local_settled_[t]);
+        return nodes;
+      });
+      relax(settled_, false, bucket);
+    }
+  }
+
+  /// return distances from the source of the last run
+  /// (std::numeric_limits<weight_type>::max() when unreachable)
+  std::vector<weight_type> distances() const {
+    std::vector<weight_type> result(g_.num_nodes());
+    for (node_t v : g_.nodes()) {
+      result[v] = distances_[v].load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+private:
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+  static constexpr std::size_t kNoBucket = std::numeric_limits<std::size_t>::max();
+  static constexpr std::size_t kParallelUnit = 64;
+
+  const graph_type &g_;
+  const int num_threads_;
+  const weight_type delta_;
+  const std::size_t num_buckets_;
+  std::vector<std::atomic<weight_type>> distances_;
+  std::vector<std::atomic<std::size_t>> settled_bucket_;
+  std::vector<std::vector<std::vector<node_t>>> local_buckets_;  // [thread][bucket % num_buckets_]
+  std::vector<std::vector<node_t>> local_settled_;                // [thread]
+  std::vector<node_t> frontier_;
+  std::vector<node_t> settled_;
+
+  static weight_type default_delta(const graph_type &g) {
+    double total = 0.0;
+    for (node_t v : g.nodes()) {
+      for (const auto &e : g.edges(v)) total += weight(e);
+    }
+    double average = g.num_edges() > 0 ? total / g.num_edges() : 1.0;
+    if constexpr (std::is_integral_v<weight_type>) {
+      return std::max<weight_type>(1, std::llround(average));
+    } else {
+      return average > 0 ? average : 1.0;
+    }
+  }
+
+  /// return the number of cyclic buckets: ceil((max weight) / |delta|) + 1 buckets suffice, and
+  /// one more bucket absorbs rounding errors of floating-point distances
+  static std::size_t num_cyclic_buckets(const graph_type &g, weight_type delta) {
+    weight_type max_weight = 0;
+    for (node_t v : g.nodes()) {
+      for (const auto &e : g.edges(v)) max_weight = std::max(max_weight, weight(e));
+    }
+    double ratio = std::ceil(static_cast<double>(max_weight) / static_cast<double>(delta));
+    ASSERT_MSG(ratio < (1 << 26), "delta is too small for the maximum edge weight: {} vs. {}",
+               delta, max_weight);
+    return static_cast<std::size_t>(ratio) + 2;
+  }
+
+  std::size_t bucket_of(weight_type d) const { return static_cast<std::size_t>(d / delta_); }
+
+  int threads_for(std::size_t n) const {
+    return std::max<int>(1, std::min<std::size_t>(num_threads_, n / kParallelUnit + 1));
+  }
+
+  /// relax light (|light|) or heavy (!|light|) edges from |nodes| of bucket |bucket|
+  void relax(const std::vector<node_t> &nodes, bool light, std::size_t bucket) {
+    parallel_for(
+        nodes.size(), kParallelUnit,
+        fn(i, t) {
+          node_t u = nodes[i];
+          weight_type du = distances_[u].load(std::memory_order_relaxed);
+          if (light) {
+            // skip stale entries (already settled in an earlier bucket)
+            if (bucket_of(du) != bucket) return;
+            if (settled_bucket_[u].exchange(bucket, std::memory_order_relaxed) != bucket) {
+              local_settled_[t].push_back(u);
+            }
+          }
+
+          for (const auto &e : g_.edges(u)) {
+            if ((weight(e) < delta_) != light) continue;
+            weight_type dv = du + weight(e);
+            if (!atomic_fetch_min(distances_[to(e)], dv)) continue;
+            auto &buckets = local_buckets_[t];
+            std::size_t b = bucket_of(dv) % num_buckets_;
+            if (buckets.size() <= b) buckets.resize(b + 1);
+            buckets[b].push_back(to(e));
+          }
+        },
+        threads_for(nodes.size()));
+  }
+
+  /// take nodes in |bucket| of thread |t|
+  std::vector<node_t> take_bucket(int t, std::size_t bucket) {
+    std::vector<node_t> nodes;
+    std::size_t b = bucket % num_buckets_;
+    if (b < local_buckets_[t].size()) nodes.swap(local_buckets_[t][b]);
+    return nodes;
+  }
+
+  /// return the smallest non-empty bucket after |bucket| (|kNoBucket| when all are empty).
+  /// all non-empty buckets are within |num_buckets_| - 1 after |bucket|
+  std::size_t next_bucket(std::size_t bucket) const {
+    std::size_t result = kNoBucket;
+    for (const auto &buckets : local_buckets_) {
+      for (std::size_t b = bucket + 1; b < std::min(bucket + num_buckets_, result); ++b) {
+        std::size_t slot = b % num_buckets_;
+        if (slot < buckets.size() && !buckets[slot].empty()) {
+          result = b;
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+  /// concatenate |take(t)| of all threads into |nodes|
+  template <typename Func>
+  void gather(std::vector<node_t> &nodes, Func take) {
+    nodes.clear();
+    for (int t : irange(num_threads_)) {
+      std::vector<node_t> local = take(t);
+      nodes.insert(nodes.end(), local.begin(), local.end());
+    }
+  }
+};
+
+/// compute single-source distances from |source| by parallel delta-stepping.
+/// result is the same as |single_source_distance|
+/// @param g input graph (weights must be non-negative)
+/// @param delta width of buckets: when specified 0, set to the average edge weight
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<typename GraphType::weight_type> delta_stepping_distance(
+    const GraphType &g, node_t source, typename GraphType::weight_type delta = 0,
+    int num_threads = 0) {
+  delta_stepping<GraphType> sssp(g, delta, num_threads);
+  sssp.run(source);
+  return sssp.distances();
+}
+}  // namespace bgl
@@ -2,38 +2,53 @@
 #include "bgl/data_structure/hyperloglog_array.hpp"
 #include "bgl/graph/basic_graph.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <functional>
+#include <type_traits>
+#include <vector>
 
 namespace bgl {
-/// run simple HyperBall. to compute centrality, transpose graph in advance
+/// run simple HyperBall. to compute centrality, transpose graph in advance.
+/// counters are stored in |CounterArray|: |hyperloglog_array|, or |packed_hyperloglog_array| to
+/// reduce the memory of two copies of counters (by 1/3 with 5-bit registers)
 /// @param g input unweighted graph
 /// @param log2k specify the number of registers of HyperLogLog counter (5 <= log2k <= 20)
 /// @param callback callback function (must be thread-safe).
 ///        arguments: current node (node_t), distance (node_t), estimated count (double)
+///        and optionally the index of thread (int), which is less than the size of
+///        |thread_pool::shared()| or |num_threads|
 /// @param threshold maximum number of iteration
 /// @param num_threads number of threads (0: auto)
 /// @see "HyperANF: Approximating the neighbourhood function of very large graphs on a budget"
 ///       (P. Boldi, M. Rosa and S. Vigna). In WWW'11.
 ///      "In-core computation of geometric centralities with HyperBall: A hundred billion nodes
 ///       and beyond" (P. Boldi and S. Vigna). In ICDMW'13.
-void hyperball(const graph &g, int log2k, std::function<void(node_t, node_t, double)> callback,
-               int threshold = 100, int num_threads = 0) {
+template <typename CounterArray = hyperloglog_array, typename GraphType, typename Callback>
+void hyperball(const GraphType &g, int log2k, const Callback &callback, int threshold = 100,
+               int num_threads = 0) {
   const node_t n = g.num_nodes();
   ASSERT(n > 0);
 
-  hyperloglog_array curr_hll(n, log2k);
+  auto call = [&](node_t v, node_t d, double count, int i) {
+    if constexpr (std::is_invocable_v<const Callback &, node_t, node_t, double, int>) {
+      callback(v, d, count, i);
+    } else {
+      callback(v, d, count);
+    }
+  };
+
+  CounterArray curr_hll(n, log2k);
   std::vector<double> cache(n);
 
   g.for_each_node(
-      fn(v, i [[maybe_unused]]) {
+      fn(v, i) {
         curr_hll[v].insert(v);
         cache[v] = curr_hll[v].count();
-        callback(v, 0, 1.0);
+        call(v, 0, 1.0, i);
       },
       num_threads);
 
-  hyperloglog_array next_hll(curr_hll);
+  CounterArray next_hll(curr_hll);
 
   std::vector<bool> curr_updated(n, true);
   std::vector<bool> next_updated;
@@ -43,7 +58,7 @@ void hyperball(const graph &g, int log2k, std::function<void(node_t, node_t, dou
     next_updated.assign(n, false);
 
     g.for_each_node(
-        fn(u, i [[maybe_unused]]) {
+        fn(u, i) {
           bool merged = false;
           for (node_t v : g.neighbors(u)) {
             if (curr_updated[v]) {
@@ -54,7 +69,7 @@ void hyperball(const graph &g, int log2k, std::function<void(node_t, node_t, dou
           if ((next_updated[u] = merged && curr_hll[u] != next_hll[u])) {
             ++num_updated;
             double count = next_hll[u].count();
-            callback(u, d + 1, count - cache[u]);
+            call(u, d + 1, count - cache[u], i);
             cache[u] = count;
           }
         },
@@ -77,4 +92,68 @@ void hyperball(const graph &g, int log2k, std::function<void(node_t, node_t, dou
     std::swap(curr_updated, next_updated);
   }
 }
+
+/// geometric centralities of each node and the neighbourhood function estimated by
+/// |hyperball_centralities|. distances are those from each node in the given graph
+struct geometric_centralities {
+  /// the number of nodes within finite distance (including the node itself)
+  std::vector<double> reachable;
+  /// the sum of distances to the reachable nodes (farness)
+  std::vector<double> sum_of_distances;
+  /// harmonic centrality: the sum of the inverse of distances to the other nodes
+  std::vector<double> harmonic;
+  /// the number of pairs of nodes for each distance
+  std::vector<double> distance_distribution;
+
+  /// closeness centrality: the inverse of farness over the reachable nodes (0 if no other node
+  /// is reachable). unlike |top_k_normalized_closeness|, it is neither multiplied by (n - 1)
+  /// nor forced to 0 when some node is unreachable
+  double closeness(node_t v) const {
+    return sum_of_distances[v] > 0.0 ? 1.0 / sum_of_distances[v] : 0.0;
+  }
+
+  /// Lin's centrality: the square of |reachable| divided by farness (1 if no other node is
+  /// reachable)
+  double lin(node_t v) const {
+    return sum_of_distances[v] > 0.0 ? reachable[v] * reachable[v] / sum_of_distances[v] : 1.0;
+  }
+};
+
+/// estimate geometric centralities by HyperBall (counters are stored in |CounterArray| as
+/// |hyperball|). to use distances to each node (the usual definitions for directed graphs),
+/// pass the transposed graph.
+/// each node is updated by one thread per iteration, so the per-node values are accumulated
+/// directly, and the distance distribution is accumulated per thread and summed at the end.
+/// @param g input unweighted graph
+/// @param log2k specify the number of registers of HyperLogLog counter (5 <= log2k <= 20)
+/// @param threshold maximum number of iteration
+/// @param num_threads number of threads (0: auto)
+template <typename CounterArray = hyperloglog_array, typename GraphType>
+geometric_centralities hyperball_centralities(const GraphType &g, int log2k,
+                                              int threshold = 100, int num_threads = 0) {
+  const node_t n = g.num_nodes();
+  const int threads = std::max<int>(num_threads, thread_pool::shared().size());
+  geometric_centralities result{std::vector<double>(n), std::vector<double>(n),
+                                std::vector<double>(n), {}};
+  std::vector<std::vector<double>> distributions(threads, std::vector<double>(threshold + 1));
+
+  hyperball<CounterArray>(
+      g, log2k,
+      fn(v, d, count, i) {
+        result.reachable[v] += count;
+        result.sum_of_distances[v] += d * count;
+        if (d > 0) result.harmonic[v] += count / d;
+        distributions[i][d] += count;
+      },
+      threshold, num_threads);
+
+  result.distance_distribution.assign(threshold + 1, 0.0);
+  for (const auto &distribution : distributions) {
+    for (node_t d : irange(threshold + 1)) result.distance_distribution[d] += distribution[d];
+  }
+  while (result.distance_distribution.size() > 1 && result.distance_distribution.back() == 0.0) {
+    result.distance_distribution.pop_back();
+  }
+  return result;
+}
 }  // namespace bgl
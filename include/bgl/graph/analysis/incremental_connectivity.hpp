@@ -0,0 +1,87 @@
+#pragma once
+#include "bgl/data_structure/union_find.hpp"
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// weakly connected components of a graph that only grows: edges are consumed one by one
+/// (or by edge lists) and merged into |union_find|, so the graph itself is never stored nor
+/// traversed. nodes are added implicitly when an edge refers to a node beyond |num_nodes|.
+/// component sizes and the largest component are maintained on each merge, and |snapshot|
+/// returns components in the same format as |weakly_connected_components| at any time.
+class incremental_connectivity {
+public:
+  /// @param num_nodes the initial number of nodes
+  incremental_connectivity(node_t num_nodes = 0) : uf_(0) { add_nodes(num_nodes); }
+
+  /// add nodes so that the number of nodes becomes |num_nodes|
+  void add_nodes(node_t num_nodes) {
+    uf_.extend(num_nodes);
+    if (num_nodes > 0 && largest_ == kInvalidNode) largest_ = 0;
+  }
+
+  /// add edge (|u|, |v|) (the direction is ignored): approximately O(1)
+  /// @return true if two components are merged
+  bool add_edge(node_t u, node_t v) {
+    add_nodes(std::max(u, v) + 1);
+    ++num_edges_;
+    if (!uf_.unite(u, v)) return false;
+    if (uf_.set_size(u) > uf_.set_size(largest_)) largest_ = u;
+    return true;
+  }
+
+  /// add all edges of |es|
+  template <typename EdgeType>
+  void add_edges(const edge_list<EdgeType> &es) {
+    for (const auto &e : es) add_edge(e.first, to(e.second));
+  }
+
+  /// return the number of nodes
+  node_t num_nodes() const { return uf_.element_count(); }
+
+  /// return the number of consumed edges
+  std::size_t num_edges() const { return num_edges_; }
+
+  /// return the number of components
+  node_t num_components() { return uf_.disjoint_count(); }
+
+  /// determine if |u| and |v| are in the same component
+  bool is_connected(node_t u, node_t v) {
+    ASSERT_MSG(u < num_nodes() && v < num_nodes(), "invalid node index");
+    return uf_.is_same(u, v);
+  }
+
+  /// return the number of nodes in the component of |v|
+  node_t component_size(node_t v) {
+    ASSERT_MSG(v < num_nodes(), "invalid node index");
+    return uf_.set_size(v);
+  }
+
+  /// return the number of nodes in the largest component (0 if there is no node)
+  node_t largest_component_size() { return num_nodes() == 0 ? 0 : uf_.set_size(largest_); }
+
+  /// return a node of the largest component (|kInvalidNode| if there is no node)
+  node_t largest_component_node() const { return largest_; }
+
+  /// return components of the current graph:
+  /// component IDs are numbered in order of their smallest node as |weakly_connected_components|
+  /// @return pair of the number of components and list of component IDs
+  std::pair<node_t, std::vector<node_t>> snapshot() {
+    std::vector<node_t> ids = uf_.components();
+    std::vector<node_t> id_of_root(ids.size(), kInvalidNode);
+    node_t num_components = 0;
+    for (node_t &id : ids) {
+      if (id_of_root[id] == kInvalidNode) id_of_root[id] = num_components++;
+      id = id_of_root[id];
+    }
+    return {num_components, ids};
+  }
+
+private:
+  union_find<node_t> uf_;
+  std::size_t num_edges_ = 0;
+  node_t largest_ = kInvalidNode;
+};
+}  // namespace bgl
@@ -0,0 +1,176 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace bgl {
+/// default number of 64-bit words of source sets in |multi_source_bfs|
+/// (256 sources with AVX2, where word-wise operations are vectorized)
+#ifdef __AVX2__
+inline constexpr std::size_t kMultiSourceBfsWords = 4;
+#else
+inline constexpr std::size_t kMultiSourceBfsWords = 1;
+#endif
+
+/// multi-source BFS (MS-BFS): run BFS from up to 64 * |NumWords| sources at once.
+/// each node holds bitsets of sources that have reached it, and one scan of edges per level
+/// advances BFS of all sources. levels are computed in parallel by pulling bitsets along
+/// in-edges (so that no atomic operations are needed).
+/// @see "The more the merrier: Efficient multi-source graph traversal"
+///      (M. Then, M. Kaufmann, F. Chirigati, et al.). In VLDB'15.
+template <typename GraphType, std::size_t NumWords = kMultiSourceBfsWords>
+class multi_source_bfs {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  static_assert(std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>,
+                "graph must be unweighted");
+
+  /// maximum number of sources in one run
+  static constexpr std::size_t kMaxSources = 64 * NumWords;
+
+  /// @param g input graph
+  /// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  multi_source_bfs(const graph_type &g, const graph_type &gt, int num_threads = 0)
+      : g_{g},
+        gt_{gt},
+        num_threads_{num_threads},
+        seen_(g.num_nodes()),
+        visit_(g.num_nodes()),
+        next_(g.num_nodes()) {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+  }
+
+  /// run BFS from |sources| simultaneously.
+  /// |callback(v, i, d)| is called when node |v| is reached from |sources[i]| at distance |d|,
+  /// once for each pair of source and node reachable from it. callback must be thread-safe,
+  /// but calls for the same node are made by one thread.
+  template <typename Callback>
+  void run(const std::vector<node_t> &sources, Callback &&callback) {
+    ASSERT_MSG(sources.size() <= kMaxSources, "too many sources: {}", sources.size());
+    std::fill(seen_.begin(), seen_.end(), source_set{});
+    std::fill(visit_.begin(), visit_.end(), source_set{});
+    source_set active{};
+    for (std::size_t i : irange(sources.size())) {
+      active.set(i);
+      seen_[sources[i]].set(i);
+      visit_[sources[i]].set(i);
+      callback(sources[i], i, weight_type(0));
+    }
+
+    for (weight_type depth = 1;; ++depth) {
+      std::atomic<bool> updated = false;
+      g_.for_each_node(
+          fn(v, t [[maybe_unused]]) {
+            source_set unseen = ~seen_[v] & active;
+            source_set reached{};
+            if (unseen.any()) {
+              for (node_t u : gt_.neighbors(v)) {
+                reached |= visit_[u];
+                if ((reached & unseen) == unseen) break;
+              }
+              reached &= unseen;
+            }
+            next_[v] = reached;
+            if (!reached.any()) return;
+
+            seen_[v] |= reached;
+            updated.store(true, std::memory_order_relaxed);
+            reached.for_each(fn(i) { callback(v, i, depth); });
+          },
+          num_threads_);
+
+      if (!updated) break;
+      visit_.swap(next_);
+    }
+  }
+
+private:
+  /// bitset of sources
+  struct source_set {
+    std::uint64_t words[NumWords] = {};
+
+    void set(std::size_t i) noexcept { words[i / 64] |= std::uint64_t(1) << (i % 64); }
+
+    bool any() const noexcept {
+      std::uint64_t x = 0;
+      for (std::size_t k = 0; k < NumWords; ++k) x |= words[k];
+      return x != 0;
+    }
+
+    source_set operator~() const noexcept {
+      source_set result;
+      for (std::size_t k = 0; k < NumWords; ++k) result.words[k] = ~words[k];
+      return result;
+    }
+
+    source_set &operator|=(const source_set &rhs) noexcept {
+      for (std::size_t k = 0; k < NumWords; ++k) words[k] |= rhs.words[k];
+      return *this;
+    }
+
+    source_set &operator&=(const source_set &rhs) noexcept {
+      for (std::size_t k = 0; k < NumWords; ++k) words[k] &= rhs.words[k];
+      return *this;
+    }
+
+    source_set operator&(const source_set &rhs) const noexcept {
+      source_set result = *this;
+      return result &= rhs;
+    }
+
+    bool operator==(const source_set &rhs) const noexcept {
+      std::uint64_t x = 0;
+      for (std::size_t k = 0; k < NumWords; ++k) x |= words[k] ^ rhs.words[k];
+      return x == 0;
+    }
+
+    /// call |f(i)| for each source index |i| in the set
+    template <typename Func>
+    void for_each(Func &&f) const {
+      for (std::size_t k = 0; k < NumWords; ++k) {
+        for (std::uint64_t w = words[k]; w != 0; w &= w - 1) {
+          f(k * 64 + __builtin_ctzll(w));
+        }
+      }
+    }
+  };
+
+  const graph_type &g_;
+  const graph_type &gt_;
+  const int num_threads_;
+  std::vector<source_set> seen_;
+  std::vector<source_set> visit_;
+  std::vector<source_set> next_;
+};
+
+/// compute distances from each of |sources| by multi-source BFS.
+/// result[i][v] is distance from |sources[i]| to |v|
+/// (std::numeric_limits<weight_type>::max() when unreachable)
+/// @param g input unweighted graph
+/// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<std::vector<typename GraphType::weight_type>> multi_source_distance(
+    const GraphType &g, const GraphType &gt, const std::vector<node_t> &sources,
+    int num_threads = 0) {
+  using weight_type = typename GraphType::weight_type;
+  using bfs_type = multi_source_bfs<GraphType>;
+  std::vector<std::vector<weight_type>> result(
+      sources.size(),
+      std::vector<weight_type>(g.num_nodes(), std::numeric_limits<weight_type>::max()));
+
+  bfs_type bfs(g, gt, num_threads);
+  for (std::size_t first = 0; first < sources.size(); first += bfs_type::kMaxSources) {
+    std::size_t last = std::min(first + bfs_type::kMaxSources, sources.size());
+    std::vector<node_t> batch(sources.begin() + first, sources.begin() + last);
+    bfs.run(batch, fn(v, i, d) { result[first + i][v] = d; });
+  }
+  return result;
+}
+}  // namespace bgl
@@ -0,0 +1,289 @@
+#pragma once
+#include "bgl/graph/analysis/minimum_degree.hpp"
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/linalg/base.hpp"
+#include "bgl/linalg/gmres.hpp"
+#include "bgl/linalg/lu.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// PageRank and personalized PageRank (PPR) of directed graph (edge weights are ignored).
+/// a random surfer follows a random out-edge with probability |damping|, and otherwise jumps to
+/// a node drawn from the teleport distribution (uniform for PageRank, and the seed for PPR of a
+/// single seed). dangling nodes (without out-edges) always jump.
+///   - power iteration is pull-based on the transposed graph: each node sums the contributions
+///     of its in-neighbors, so that nodes are updated in parallel without atomic operations.
+///   - forward push approximates PPR locally: residual mass of a node is pushed to its
+///     out-neighbors while it exceeds |epsilon| times the outdegree, so the work does not depend
+///     on the size of graph. multiple seeds are processed in parallel.
+///   - exact PPR solves the linear system (I - damping * P^T) x = (1 - damping) e_seed by GMRES,
+///     where nodes are ordered by |min_degree_eliminator| and the matrix is preconditioned by
+///     incomplete LU decomposition that is exact on the eliminated (low-degree) part.
+/// statistics of the last computation are available by |num_iterations|, |residual| and
+/// |num_pushes|.
+/// @see "Local graph partitioning using PageRank vectors"
+///      (R. Andersen, F. Chung and K. Lang). In FOCS'06.
+///      "Computing personalized PageRank quickly by exploiting graph structures"
+///      (T. Maehara, T. Akiba, Y. Iwata and K. Kawarabayashi). In VLDB'14.
+template <typename GraphType>
+class pagerank_solver {
+public:
+  using graph_type = GraphType;
+
+  /// @param g input graph
+  /// @param gt transposed graph of |g|
+  /// @param damping probability of following an out-edge
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  pagerank_solver(const graph_type &g, const graph_type &gt, double damping = 0.85,
+                  int num_threads = 0)
+      : g_{g},
+        gt_{gt},
+        damping_{damping},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        workspaces_(num_threads_) {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+    ASSERT_MSG(0.0 <= damping && damping < 1.0, "damping factor must be in [0, 1)");
+  }
+
+  /// compute PageRank by power iteration until the 1-norm of update is at most |tol|
+  real_vector pagerank(double tol = 1e-9, int max_iter = 100) {
+    return personalized_pagerank(real_vector(g_.num_nodes(), 1.0 / g_.num_nodes()), tol,
+                                 max_iter);
+  }
+
+  /// compute PPR for |teleport| distribution (sum must be 1) by power iteration until the
+  /// 1-norm of update is at most |tol|
+  real_vector personalized_pagerank(const real_vector &teleport, double tol = 1e-9,
+                                    int max_iter = 100) {
+    const node_t n = g_.num_nodes();
+    ASSERT_MSG(teleport.size() == n, "size does not match");
+    real_vector x = teleport, next(n), contributions(n);
+    std::vector<double> partial_sums(num_threads_);
+
+    num_iterations_ = 0;
+    residual_ = std::numeric_limits<double>::infinity();
+    while (num_iterations_ < max_iter && residual_ > tol) {
+      ++num_iterations_;
+      std::fill(partial_sums.begin(), partial_sums.end(), 0.0);
+      parallel_for(
+          n, kParallelUnit * 16,
+          fn(v, t) {
+            if (g_.outdegree(v) == 0) {
+              contributions[v] = 0.0;
+              partial_sums[t] += x[v];
+            } else {
+              contributions[v] = x[v] / g_.outdegree(v);
+            }
+          },
+          num_threads_);
+      const double dangling = sum_of(partial_sums);
+
+      std::fill(partial_sums.begin(), partial_sums.end(), 0.0);
+      gt_.for_each_node(
+          fn(v, t) {
+            double sum = 0.0;
+            for (node_t u : gt_.neighbors(v)) sum += contributions[u];
+            next[v] = (1.0 - damping_ + damping_ * dangling) * teleport[v] + damping_ * sum;
+            partial_sums[t] += std::abs(next[v] - x[v]);
+          },
+          num_threads_);
+      residual_ = sum_of(partial_sums);
+      std::swap(x, next);
+    }
+    return x;
+  }
+
+  /// approximate PPR of |seed| by forward push: pushes stop when the residual mass of each node
+  /// |v| is at most |epsilon| * max(1, outdegree(v)). values never exceed the exact ones, and
+  /// |residual| is the total residual mass, i.e., the 1-norm of the error.
+  /// @return pairs of node and PPR value (nodes with nonzero value in increasing order)
+  std::vector<std::pair<node_t, double>> forward_push(node_t seed, double epsilon = 1e-6) {
+    ASSERT_MSG(seed < g_.num_nodes(), "invalid node index");
+    auto result = forward_push(seed, epsilon, workspaces_[0]);
+    num_pushes_ = workspaces_[0].num_pushes;
+    residual_ = workspaces_[0].residual;
+    return result;
+  }
+
+  /// approximate PPR of each seed of |seeds| by forward push in parallel (see |forward_push|).
+  /// |num_pushes| and |residual| are summed over all seeds
+  std::vector<std::vector<std::pair<node_t, double>>> forward_push(
+      const std::vector<node_t> &seeds, double epsilon = 1e-6) {
+    std::vector<std::vector<std::pair<node_t, double>>> results(seeds.size());
+    std::vector<std::size_t> num_pushes(num_threads_);
+    std::vector<double> residuals(num_threads_);
+    parallel_for(
+        seeds.size(), 1,
+        fn(i, t) {
+          ASSERT_MSG(seeds[i] < g_.num_nodes(), "invalid node index");
+          results[i] = forward_push(seeds[i], epsilon, workspaces_[t]);
+          num_pushes[t] += workspaces_[t].num_pushes;
+          residuals[t] += workspaces_[t].residual;
+        },
+        num_threads_);
+    num_pushes_ = 0;
+    for (std::size_t c : num_pushes) num_pushes_ += c;
+    residual_ = sum_of(residuals);
+    return results;
+  }
+
+  /// prepare exact PPR: order nodes by |min_degree_eliminator| eliminating nodes of degree at
+  /// most |max_width| (on the undirected skeleton of |g|), and compute incomplete LU
+  /// decomposition of the reordered matrix that is exact on the eliminated nodes
+  void prepare_exact(int max_width = 64) {
+    const node_t n = g_.num_nodes();
+    unweighted_adjacency_list skeleton(n);
+    for (node_t v : g_.nodes()) {
+      for (node_t w : g_.neighbors(v)) {
+        if (v == w) continue;
+        skeleton[v].push_back(w);
+        skeleton[w].push_back(v);
+      }
+    }
+    graph structure(std::move(skeleton));
+    structure.simplify();
+    min_degree_eliminator eliminator(std::move(structure), max_width);
+    const std::vector<node_t> &order = eliminator.ordering();
+    rank_.resize(n);
+    for (node_t i : irange(n)) rank_[order[i]] = i;
+
+    // row of |v| is 1 on diagonal and -damping / outdegree(u) for each in-edge from |u|
+    weighted_adjacency_list<double> rows(n);
+    for (node_t v : g_.nodes()) {
+      auto &row = rows[rank_[v]];
+      row.emplace_back(rank_[v], 1.0);
+      for (node_t u : gt_.neighbors(v)) row.emplace_back(rank_[u], -damping_ / g_.outdegree(u));
+      std::sort(row.begin(), row.end());
+      // merge multiple edges and self loops
+      std::size_t k = 0;
+      for (std::size_t i : irange(row.size())) {
+        if (k > 0 && to(row[k - 1]) == to(row[i])) {
+          row[k - 1].second += weight(row[i]);
+        } else {
+          row[k++] = row[i];
+        }
+      }
+      row.resize(k);
+    }
+    matrix_.assign(std::move(rows));
+    precond_ = ilu_decomposition(matrix_, eliminator.width_ends().back());
+  }
+
+  /// compute PPR of |seed| exactly by GMRES(|restart|) with at most |max_iter| restarts until the
+  /// relative residual is at most |tol| (|prepare_exact| must be called in advance).
+  /// |num_iterations| is the total number of GMRES iterations, and |residual| is the relative
+  /// residual
+  real_vector exact_personalized_pagerank(node_t seed, double tol = 1e-10, int restart = 30,
+                                          int max_iter = 100) {
+    ASSERT_MSG(!matrix_.empty(), "prepare_exact() must be called in advance");
+    ASSERT_MSG(seed < g_.num_nodes(), "invalid node index");
+    const node_t n = g_.num_nodes();
+    real_vector b(n);
+    b[rank_[seed]] = 1.0 - damping_;
+    real_vector z = gmres(matrix_, b, precond_, {}, tol, restart, max_iter, &num_iterations_);
+    residual_ = (b - matrix_ * z).norm() / b.norm();
+
+    // mass of dangling nodes returns to |seed|, which only scales the solution
+    const double sum = z.sum();
+    real_vector x(n);
+    for (node_t v : g_.nodes()) x[v] = z[rank_[v]] / sum;
+    return x;
+  }
+
+  /// return the number of iterations of the last power iteration or exact PPR
+  int num_iterations() const noexcept { return num_iterations_; }
+
+  /// return the 1-norm of the last update of power iteration, the total error of forward push,
+  /// or the relative residual of exact PPR
+  double residual() const noexcept { return residual_; }
+
+  /// return the number of pushes of the last forward push
+  std::size_t num_pushes() const noexcept { return num_pushes_; }
+
+private:
+  static constexpr std::size_t kParallelUnit = 1024;
+
+  /// buffers of forward push for each thread: reset in time proportional to the touched nodes
+  struct workspace {
+    std::vector<double> estimates;
+    std::vector<double> residuals;
+    std::vector<bool> in_queue;
+    std::vector<node_t> touched;
+    std::deque<node_t> queue;
+    std::size_t num_pushes = 0;
+    double residual = 0.0;
+  };
+
+  const graph_type &g_;
+  const graph_type &gt_;
+  const double damping_;
+  const int num_threads_;
+  std::vector<workspace> workspaces_;
+  int num_iterations_ = 0;
+  double residual_ = 0.0;
+  std::size_t num_pushes_ = 0;
+  std::vector<node_t> rank_;
+  sparse_matrix matrix_;
+  std::pair<sparse_matrix, sparse_matrix> precond_;
+
+  static double sum_of(const std::vector<double> &xs) {
+    double result = 0.0;
+    for (double x : xs) result += x;
+    return result;
+  }
+
+  std::vector<std::pair<node_t, double>> forward_push(node_t seed, double epsilon,
+                                                      workspace &ws) const {
+    const node_t n = g_.num_nodes();
+    if (ws.estimates.size() != n) {
+      ws.estimates.assign(n, 0.0);
+      ws.residuals.assign(n, 0.0);
+      ws.in_queue.assign(n, false);
+    }
+    auto add_residual = [&](node_t v, double r) {
+      if (ws.estimates[v] == 0.0 && ws.residuals[v] == 0.0) ws.touched.push_back(v);
+      ws.residuals[v] += r;
+      const double threshold = epsilon * std::max<std::size_t>(1, g_.outdegree(v));
+      if (!ws.in_queue[v] && ws.residuals[v] > threshold) {
+        ws.in_queue[v] = true;
+        ws.queue.push_back(v);
+      }
+    };
+
+    ws.num_pushes = 0;
+    add_residual(seed, 1.0);
+    while (!ws.queue.empty()) {
+      node_t u = ws.queue.front();
+      ws.queue.pop_front();
+      ws.in_queue[u] = false;
+      const double r = ws.residuals[u];
+      ws.residuals[u] = 0.0;
+      ws.estimates[u] += (1.0 - damping_) * r;
+      ++ws.num_pushes;
+      if (g_.outdegree(u) == 0) {
+        add_residual(seed, damping_ * r);
+      } else {
+        const double share = damping_ * r / g_.outdegree(u);
+        for (node_t w : g_.neighbors(u)) add_residual(w, share);
+      }
+    }
+
+    std::sort(ws.touched.begin(), ws.touched.end());
+    std::vector<std::pair<node_t, double>> result;
+    ws.residual = 0.0;
+    for (node_t v : ws.touched) {
+      if (ws.estimates[v] > 0.0) result.emplace_back(v, ws.estimates[v]);
+      ws.residual += ws.residuals[v];
+      ws.estimates[v] = ws.residuals[v] = 0.0;
+    }
+    ws.touched.clear();
+    return result;
+  }
+};
+}  // namespace bgl
@@ -0,0 +1,274 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace bgl {
+/// point-to-point shortest path queries by bidirectional search.
+/// forward search runs on |g| from the source and backward search runs on its transposed graph
+/// from the target, and the query stops as soon as no shorter path than the best meeting can
+/// exist, so only small balls around the endpoints are explored.
+/// unweighted graphs are searched by level-synchronous bidirectional BFS, and weighted ones by
+/// bidirectional Dijkstra. with landmarks, both searches become A* search guided by lower bounds
+/// from the triangle inequality (ALT). buffers are reset in time proportional to the explored
+/// region, so the object should be reused across queries.
+/// @see "Computing the shortest path: A* search meets graph theory"
+///      (A. V. Goldberg and C. Harrelson). In SODA'05.
+template <typename GraphType>
+class point_to_point_query {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  static_assert(std::is_arithmetic_v<weight_type>, "edge weight must be arithmetic type");
+
+  /// @param g input graph (weights must be non-negative)
+  /// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+  /// @param num_landmarks the number of ALT landmarks (see |select_landmarks|)
+  point_to_point_query(const graph_type &g, const graph_type &gt, std::size_t num_landmarks = 0)
+      : graphs_{&g, &gt},
+        heaps_{{dijkstra_heap<graph_type>(g), dijkstra_heap<graph_type>(gt)}} {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+    for (int dir : {0, 1}) {
+      distances_[dir].assign(g.num_nodes(), kInfinity);
+      parents_[dir].assign(g.num_nodes(), kInvalidNode);
+    }
+    select_landmarks(num_landmarks);
+  }
+
+  /// choose |num_landmarks| landmarks greedily: start from the node of the largest outdegree,
+  /// and then repeatedly add the node farthest from the chosen ones (unreachable nodes first).
+  /// time complexity: O(|num_landmarks| * (single-source distance))
+  void select_landmarks(std::size_t num_landmarks) {
+    clear_landmarks();
+    const node_t n = graphs_[0]->num_nodes();
+    if (num_landmarks == 0 || n == 0) return;
+
+    node_t next = 0;
+    for (node_t v : graphs_[0]->nodes()) {
+      if (graphs_[0]->outdegree(v) > graphs_[0]->outdegree(next)) next = v;
+    }
+    std::vector<double> farness(n, std::numeric_limits<double>::infinity());
+    while (landmarks_.size() < num_landmarks) {
+      add_landmark(next);
+      const std::size_t i = landmarks_.size() - 1;
+      for (node_t v : graphs_[0]->nodes()) {
+        farness[v] = std::min(farness[v], separation(landmark_distances_[0][i][v],
+                                                     landmark_distances_[1][i][v]));
+      }
+      next = std::max_element(farness.begin(), farness.end()) - farness.begin();
+      if (farness[next] == 0.0) break;
+    }
+  }
+
+  /// use |landmarks| as ALT landmarks
+  void set_landmarks(const std::vector<node_t> &landmarks) {
+    clear_landmarks();
+    for (node_t l : landmarks) add_landmark(l);
+  }
+
+  /// return the current landmarks
+  const std::vector<node_t> &landmarks() const noexcept { return landmarks_; }
+
+  /// return the distance from |source| to |target|
+  /// (std::numeric_limits<weight_type>::max() when unreachable).
+  /// when |compute_path|, a shortest path is also computed (see |path|)
+  weight_type query(node_t source, node_t target, bool compute_path = false) {
+    ASSERT_MSG(source < graphs_[0]->num_nodes() && target < graphs_[0]->num_nodes(),
+               "invalid node index");
+    reset();
+    endpoints_ = {target, source};
+    distances_[0][source] = 0;
+    parents_[0][source] = source;
+    touched_[0].push_back(source);
+    distances_[1][target] = 0;
+    parents_[1][target] = target;
+    touched_[1].push_back(target);
+    best_ = source == target ? 0 : kInfinity;
+    meet_ = source == target ? source : kInvalidNode;
+
+    if (source != target) {
+      if constexpr (std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>) {
+        if (landmarks_.empty()) {
+          bidirectional_bfs(source, target);
+        } else {
+          bidirectional_dijkstra(source, target);
+        }
+      } else {
+        bidirectional_dijkstra(source, target);
+      }
+    }
+
+    if (compute_path && meet_ != kInvalidNode) {
+      for (node_t v = meet_; v != source; v = parents_[0][v]) path_.push_back(v);
+      path_.push_back(source);
+      std::reverse(path_.begin(), path_.end());
+      for (node_t v = meet_; v != target;) {
+        v = parents_[1][v];
+        path_.push_back(v);
+      }
+    }
+    return best_;
+  }
+
+  /// return a shortest path (source and target inclusive) of the last query with
+  /// |compute_path| (empty when unreachable)
+  const std::vector<node_t> &path() const noexcept { return path_; }
+
+private:
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+
+  // index 0 is the forward search on |g|, and index 1 is the backward search on transposed graph
+  std::array<const graph_type *, 2> graphs_;
+  std::array<dijkstra_heap<graph_type>, 2> heaps_;
+  std::array<std::vector<weight_type>, 2> distances_;
+  std::array<std::vector<node_t>, 2> parents_;    // successor on path for backward search
+  std::array<std::vector<node_t>, 2> touched_;    // nodes with finite distance
+  std::array<std::vector<node_t>, 2> frontiers_;  // for bidirectional BFS
+  std::array<node_t, 2> endpoints_;               // search of each direction heads for these
+  weight_type best_ = kInfinity;
+  node_t meet_ = kInvalidNode;
+  std::vector<node_t> path_;
+
+  std::vector<node_t> landmarks_;
+  // [0][i][v]: distance from v to landmark i, [1][i][v]: distance from landmark i to v
+  std::array<std::vector<std::vector<weight_type>>, 2> landmark_distances_;
+
+  /// separation of node and landmark by distances |x| and |y| in both directions
+  /// (infinity only when they are not connected at all)
+  static double separation(weight_type x, weight_type y) {
+    if (x == kInfinity && y == kInfinity) return std::numeric_limits<double>::infinity();
+    return (x == kInfinity ? 0.0 : double(x)) + (y == kInfinity ? 0.0 : double(y));
+  }
+
+  void clear_landmarks() {
+    landmarks_.clear();
+    for (auto &ds : landmark_distances_) ds.clear();
+  }
+
+  void add_landmark(node_t l) {
+    ASSERT_MSG(l < graphs_[0]->num_nodes(), "invalid node index");
+    landmarks_.push_back(l);
+    landmark_distances_[0].push_back(single_source_distance(*graphs_[1], l));
+    landmark_distances_[1].push_back(single_source_distance(*graphs_[0], l));
+  }
+
+  void reset() {
+    for (int dir : {0, 1}) {
+      for (node_t v : touched_[dir]) {
+        distances_[dir][v] = kInfinity;
+        parents_[dir][v] = kInvalidNode;
+      }
+      touched_[dir].clear();
+      heaps_[dir].clear();
+    }
+    path_.clear();
+  }
+
+  /// lower bound of the distance between |v| and the endpoint of search |dir| by landmarks
+  /// (|kInfinity| when |v| cannot be on any path between the source and the target).
+  /// forward bounds d(v, t) by d(v, l) - d(t, l) and d(l, t) - d(l, v), and backward bounds
+  /// d(s, v) symmetrically, i.e., by swapping the roles of the two distance tables
+  weight_type potential(int dir, node_t v) const {
+    const node_t x = endpoints_[dir];
+    const auto &to_l = landmark_distances_[dir];
+    const auto &from_l = landmark_distances_[1 - dir];
+    weight_type result = 0;
+    auto bound = [&](weight_type far, weight_type near) {
+      if (near == kInfinity) return true;  // no information
+      if (far == kInfinity) return false;  // |v| and |x| are separated
+      if (far > near) result = std::max<weight_type>(result, far - near);
+      return true;
+    };
+    for (std::size_t i : irange(landmarks_.size())) {
+      if (!bound(to_l[i][v], to_l[i][x]) || !bound(from_l[i][x], from_l[i][v])) return kInfinity;
+    }
+    return result;
+  }
+
+  /// record |v| as the meeting point when it gives a shorter path
+  void update_best(node_t v) {
+    if (distances_[0][v] == kInfinity || distances_[1][v] == kInfinity) return;
+    weight_type d = distances_[0][v] + distances_[1][v];
+    if (d < best_) {
+      best_ = d;
+      meet_ = v;
+    }
+  }
+
+  /// expand the smaller frontier by one level until the searches meet
+  void bidirectional_bfs(node_t source, node_t target) {
+    frontiers_[0].assign(1, source);
+    frontiers_[1].assign(1, target);
+    std::vector<node_t> next;
+    // every path shorter than the first meeting is found within the level of the meeting
+    while (best_ == kInfinity && !frontiers_[0].empty() && !frontiers_[1].empty()) {
+      const int dir = frontiers_[0].size() <= frontiers_[1].size() ? 0 : 1;
+      next.clear();
+      for (node_t u : frontiers_[dir]) {
+        for (node_t v : graphs_[dir]->neighbors(u)) {
+          if (distances_[dir][v] != kInfinity) continue;
+          distances_[dir][v] = distances_[dir][u] + 1;
+          parents_[dir][v] = u;
+          touched_[dir].push_back(v);
+          next.push_back(v);
+          update_best(v);
+        }
+      }
+      frontiers_[dir].swap(next);
+    }
+  }
+
+  /// scan the search with the smaller key until the keys show that |best_| is optimal
+  void bidirectional_dijkstra(node_t source, node_t target) {
+    const bool use_potentials = !landmarks_.empty();
+    for (int dir : {0, 1}) {
+      weight_type p = potential(dir, dir == 0 ? source : target);
+      if (p == kInfinity) return;
+      heaps_[dir].decrease(dir == 0 ? source : target, p);
+    }
+
+    while (!heaps_[0].empty() && !heaps_[1].empty()) {
+      weight_type keys[2] = {heaps_[0].top_weight(), heaps_[1].top_weight()};
+      // with potentials, each search is A* on its own and its key bounds the remaining paths.
+      // otherwise, the sum of the radii of the two balls does
+      if (use_potentials ? std::max(keys[0], keys[1]) >= best_ : keys[0] >= best_ - keys[1]) {
+        break;
+      }
+
+      const int dir = keys[0] <= keys[1] ? 0 : 1;
+      const node_t u = heaps_[dir].top_vertex();
+      heaps_[dir].pop();
+      const weight_type du = distances_[dir][u];
+      for (const auto &e : graphs_[dir]->edges(u)) {
+        const node_t v = to(e);
+        const weight_type dv = du + weight(e);
+        if (is_le(distances_[dir][v], dv)) continue;
+        const weight_type p = use_potentials ? potential(dir, v) : 0;
+        if (p == kInfinity) continue;
+        if (distances_[dir][v] == kInfinity) touched_[dir].push_back(v);
+        distances_[dir][v] = dv;
+        parents_[dir][v] = u;
+        // keys must not decrease for radix heap (rounding errors of floating-point potentials)
+        heaps_[dir].decrease(v, std::max(dv + p, keys[dir]));
+        update_best(v);
+      }
+    }
+  }
+};
+
+/// compute the distance from |source| to |target| by bidirectional search.
+/// result is the same as |single_source_distance(g, source)[target]|.
+/// create |point_to_point_query| directly for many queries
+/// @param g input graph (weights must be non-negative)
+/// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+template <typename GraphType>
+typename GraphType::weight_type point_to_point_distance(const GraphType &g, const GraphType &gt,
+                                                        node_t source, node_t target) {
+  return point_to_point_query<GraphType>(g, gt).query(source, target);
+}
+}  // namespace bgl
@@ -0,0 +1,417 @@
+#pragma once
+#include "bgl/graph/analysis/slashburn.hpp"
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/io.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// order nodes for pruned landmark labeling by decreasing degree (outdegree + indegree)
+/// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected)
+template <typename GraphType>
+std::vector<node_t> hub_ordering_by_degree(const GraphType &g, const GraphType &gt) {
+  std::vector<node_t> order(g.num_nodes());
+  std::iota(order.begin(), order.end(), 0);
+  auto degree = fn(v) { return g.outdegree(v) + (&g == &gt ? 0 : gt.outdegree(v)); };
+  std::stable_sort(order.begin(), order.end(), fn(v, w) { return degree(v) > degree(w); });
+  return order;
+}
+
+/// order nodes for pruned landmark labeling by SlashBurn (hubs first)
+template <typename GraphType>
+std::vector<node_t> hub_ordering_by_slashburn(const GraphType &g, double r = 0.01) {
+  std::vector<node_t> order = slashburn_ordering(g, r).first;
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/*
+ *  index format of pruned landmark labeling:
+ *    - 4 bytes: magic constant: "pll\0"
+ *    - 4 bytes: distance size [byte]
+ *    - 4 bytes: whether distance type is integral (0 or 1)
+ *    - 4 bytes: the number of nodes (n)
+ *    - 4 bytes: whether labels are directed (0 or 1)
+ *    - 4 bytes: the number of bit-parallel roots (b)
+ *    - (distance size) * n * b bytes: distances of bit-parallel labels
+ *    - 16 * n * b bytes: neighbor sets of bit-parallel labels
+ *    + repeat (1 + directed) times (out-labels, and then in-labels):
+ *        - 8 bytes: the number of label entries (m)
+ *        - 8 * (n + 1) bytes: offset table: entries of node v are [offsets[v], offsets[v + 1])
+ *        - 4 * m bytes: hubs (ranks in the ordering, sorted for each node)
+ *        - (distance size) * m bytes: distances
+ */
+
+/// pruned landmark labeling (2-hop cover index) for exact distance queries.
+/// searches are run from nodes in the order of importance, and each search is pruned at nodes
+/// whose distance is already answered by the labels so far. a query merges two sorted labels,
+/// which takes microseconds on real-world networks with a good ordering (e.g., by degree).
+/// for unweighted undirected graphs, the first roots can be replaced by bit-parallel labels:
+/// each of them covers a root and up to 64 of its neighbors at once, and their BFS run in
+/// parallel. the index can be saved and loaded by |write| and |read|.
+/// @see "Fast exact shortest-path distance queries on large networks by pruned landmark
+///      labeling" (T. Akiba, Y. Iwata and Y. Yoshida). In SIGMOD'13.
+template <typename GraphType>
+class pruned_landmark_labeling {
+public:
+  using graph_type = GraphType;
+  using weight_type = typename GraphType::weight_type;
+  static_assert(std::is_arithmetic_v<weight_type>, "edge weight must be arithmetic type");
+
+  /// empty index (use |read| to load)
+  pruned_landmark_labeling() {}
+
+  /// build index of |g|
+  /// @param g input graph (weights must be non-negative)
+  /// @param gt transposed graph of |g| (pass |g| itself when |g| is undirected: labels are then
+  ///           shared by both directions)
+  /// @param order nodes in decreasing order of importance: when empty, |hub_ordering_by_degree|
+  /// @param num_bit_parallel_roots [unweighted undirected graph only] the number of bit-parallel
+  ///                               labels (64 for example)
+  /// @param num_threads the number of threads for bit-parallel labels: when specified 0, set
+  ///                    automatically
+  pruned_landmark_labeling(const graph_type &g, const graph_type &gt,
+                           std::vector<node_t> order = {},
+                           std::size_t num_bit_parallel_roots = 0, int num_threads = 0)
+      : num_nodes_{g.num_nodes()}, directed_{&g != &gt} {
+    ASSERT_MSG(g.num_nodes() == gt.num_nodes(), "number of nodes does not match");
+    if (order.empty()) order = hub_ordering_by_degree(g, gt);
+    ASSERT_MSG(order.size() == num_nodes_, "invalid ordering: size does not match");
+
+    std::vector<bool> used(num_nodes_, false);
+    if (num_bit_parallel_roots > 0) {
+      if constexpr (std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>) {
+        ASSERT_MSG(!directed_, "bit-parallel labels require undirected graph (pass g as gt)");
+        build_bit_parallel_labels(g, order, num_bit_parallel_roots, used, num_threads);
+      } else {
+        ASSERT_MSG(false, "bit-parallel labels require unweighted graph");
+      }
+    }
+    build_labels(g, gt, order, used);
+  }
+
+  /// return distance from |s| to |t| (std::numeric_limits<weight_type>::max() when unreachable)
+  weight_type query(node_t s, node_t t) const {
+    weight_type result = bit_parallel_distance(s, t);
+    const label_set &out = labels_[0];
+    const label_set &in = labels_[directed_ ? 1 : 0];
+    std::uint64_t i = out.offsets[s], i_end = out.offsets[s + 1];
+    std::uint64_t j = in.offsets[t], j_end = in.offsets[t + 1];
+    while (i < i_end && j < j_end) {
+      if (out.hubs[i] < in.hubs[j]) {
+        ++i;
+      } else if (out.hubs[i] > in.hubs[j]) {
+        ++j;
+      } else {
+        result = std::min<weight_type>(result, out.distances[i++] + in.distances[j++]);
+      }
+    }
+    return result;
+  }
+
+  /// return the number of nodes
+  node_t num_nodes() const noexcept { return num_nodes_; }
+
+  /// check if labels are directed (i.e., built with different |g| and |gt|)
+  bool directed() const noexcept { return directed_; }
+
+  /// return the number of bit-parallel labels per node
+  std::size_t num_bit_parallel_roots() const noexcept { return num_bit_parallel_roots_; }
+
+  /// return the total number of label entries (excluding bit-parallel labels)
+  std::size_t num_label_entries() const noexcept {
+    return labels_[0].hubs.size() + (directed_ ? labels_[1].hubs.size() : 0);
+  }
+
+  /// return the average number of label entries per node (excluding bit-parallel labels)
+  double average_label_size() const noexcept {
+    return num_nodes_ == 0 ? 0.0 : double(num_label_entries()) / num_nodes_;
+  }
+
+  /// write index to |os|
+  void write(std::ostream &os) const {
+    ASSERT_MSG(os, "empty stream");
+    os.write("pll", 4);
+    write_binary(os, static_cast<std::uint32_t>(sizeof(weight_type)));
+    write_binary(os, static_cast<std::uint32_t>(std::is_integral_v<weight_type>));
+    write_binary(os, num_nodes_);
+    write_binary(os, static_cast<std::uint32_t>(directed_));
+    write_binary(os, static_cast<std::uint32_t>(num_bit_parallel_roots_));
+    write_vector(os, bp_distances_);
+    write_vector(os, bp_sets_);
+    for (int i : irange(directed_ ? 2 : 1)) {
+      write_binary(os, static_cast<std::uint64_t>(labels_[i].hubs.size()));
+      write_vector(os, labels_[i].offsets);
+      write_vector(os, labels_[i].hubs);
+      write_vector(os, labels_[i].distances);
+    }
+    os.flush();
+  }
+
+  /// write index to |filename|
+  void write(const path &filename) const {
+    std::ofstream ofs(filename.string(), std::ios_base::binary);
+    ASSERT_MSG(ofs, "file cannot open: {}", filename);
+    write(ofs);
+  }
+
+  /// read index from |is|
+  static pruned_landmark_labeling read(std::istream &is) {
+    ASSERT_MSG(is, "empty stream");
+    char buf[4];
+    is.read(buf, 4);
+    ASSERT_MSG(
+        is.gcount() == 4 && buf[0] == 'p' && buf[1] == 'l' && buf[2] == 'l' && buf[3] == '\0',
+        "invalid header");
+    std::uint32_t weight_size = read_binary<std::uint32_t>(is);
+    bool is_integral = read_binary<std::uint32_t>(is);
+    ASSERT_MSG(weight_size == sizeof(weight_type) && is_integral == std::is_integral_v<weight_type>,
+               "type of distance does not match\n  read as: {}\n"
+               "  input type: size = {} byte(s), is_integral = {}",
+               typename_of(weight_type{}), weight_size, is_integral);
+
+    pruned_landmark_labeling index;
+    index.num_nodes_ = read_binary<node_t>(is);
+    index.directed_ = read_binary<std::uint32_t>(is);
+    index.num_bit_parallel_roots_ = read_binary<std::uint32_t>(is);
+    std::size_t bp_size = std::size_t(index.num_nodes_) * index.num_bit_parallel_roots_;
+    read_vector(is, index.bp_distances_, bp_size);
+    read_vector(is, index.bp_sets_, bp_size);
+    for (int i : irange(index.directed_ ? 2 : 1)) {
+      label_set &labels = index.labels_[i];
+      std::uint64_t num_entries = read_binary<std::uint64_t>(is);
+      read_vector(is, labels.offsets, std::size_t(index.num_nodes_) + 1);
+      read_vector(is, labels.hubs, num_entries);
+      read_vector(is, labels.distances, num_entries);
+      ASSERT_MSG(is && is_valid_offset_table(labels.offsets.data(), index.num_nodes_, num_entries),
+                 "read failed (invalid index file)");
+      const node_t n = index.num_nodes_;
+      ASSERT_MSG(std::all_of(labels.hubs.begin(), labels.hubs.end(), fn(h) { return h < n; }),
+                 "read failed (invalid index file)");
+    }
+
+    is.peek();
+    ASSERT_MSG(is.eof() && !is.fail(), "read failed (invalid index file)");
+    return index;
+  }
+
+  /// read index from |filename|
+  static pruned_landmark_labeling read(const path &filename) {
+    std::ifstream ifs(filename.string(), std::ios_base::binary);
+    ASSERT_MSG(ifs, "file cannot open: {}", filename);
+    return read(ifs);
+  }
+
+private:
+  using bit_parallel_sets = std::array<std::uint64_t, 2>;
+  static constexpr weight_type kInfinity = std::numeric_limits<weight_type>::max();
+  static constexpr std::size_t kMaxBitParallelNeighbors = 64;
+
+  /// labels of all nodes: entries of node v are [offsets[v], offsets[v + 1])
+  struct label_set {
+    std::vector<std::uint64_t> offsets = {0};
+    std::vector<node_t> hubs;  // ranks in the ordering (sorted for each node)
+    std::vector<weight_type> distances;
+  };
+
+  node_t num_nodes_ = 0;
+  bool directed_ = false;
+  std::size_t num_bit_parallel_roots_ = 0;
+  // index 0 holds out-labels (distance to hubs), and index 1 holds in-labels when directed
+  std::array<label_set, 2> labels_;
+  // bit-parallel labels: entry of node v and root i is at [v * num_bit_parallel_roots_ + i]
+  std::vector<weight_type> bp_distances_;
+  std::vector<bit_parallel_sets> bp_sets_;
+
+  template <typename T>
+  static void write_vector(std::ostream &os, const std::vector<T> &vec) {
+    os.write(reinterpret_cast<const char *>(vec.data()), vec.size() * sizeof(T));
+  }
+
+  /// read |size| elements into |vec|. sizes exceeding the rest of a seekable stream are rejected
+  /// before resizing, so that a corrupt index file does not cause a huge allocation
+  template <typename T>
+  static void read_vector(std::istream &is, std::vector<T> &vec, std::uint64_t size) {
+    ASSERT_MSG(size <= remaining_bytes(is) / sizeof(T), "read failed (invalid index file)");
+    vec.resize(size);
+    is.read(reinterpret_cast<char *>(vec.data()), size * sizeof(T));
+  }
+
+  /// return the number of bytes left in |is| (the maximum value when |is| is not seekable)
+  static std::uint64_t remaining_bytes(std::istream &is) {
+    const std::istream::pos_type pos = is.tellg();
+    if (pos == std::istream::pos_type(-1)) return std::numeric_limits<std::uint64_t>::max();
+    is.seekg(0, std::ios_base::end);
+    const std::istream::pos_type end = is.tellg();
+    is.seekg(pos);
+    return end - pos;
+  }
+
+  /// upper bound of distance between |s| and |t| by bit-parallel labels: the minimum length of
+  /// paths through a root or one of its selected neighbors (exact when one of them is |s|)
+  weight_type bit_parallel_distance(node_t s, node_t t) const {
+    weight_type result = kInfinity;
+    const std::size_t k = num_bit_parallel_roots_;
+    for (std::size_t i : irange(k)) {
+      weight_type ds = bp_distances_[s * k + i], dt = bp_distances_[t * k + i];
+      if (ds == kInfinity || dt == kInfinity) continue;
+      weight_type d = ds + dt;
+      if (d - 2 >= result) continue;
+      const bit_parallel_sets &ss = bp_sets_[s * k + i], &ts = bp_sets_[t * k + i];
+      if (ss[0] & ts[0]) {
+        d -= 2;
+      } else if ((ss[0] & ts[1]) | (ss[1] & ts[0])) {
+        d -= 1;
+      }
+      result = std::min(result, d);
+    }
+    return result;
+  }
+
+  /// select roots of bit-parallel labels with their neighbors in |order|, and then run BFS from
+  /// the roots in parallel. selected nodes are marked in |used|
+  void build_bit_parallel_labels(const graph_type &g, const std::vector<node_t> &order,
+                                 std::size_t num_roots, std::vector<bool> &used, int num_threads) {
+    std::vector<node_t> roots;
+    std::vector<std::vector<node_t>> neighbors;
+    for (std::size_t rank = 0; roots.size() < num_roots; ++rank) {
+      while (rank < num_nodes_ && used[order[rank]]) ++rank;
+      if (rank == num_nodes_) break;
+      node_t r = order[rank];
+      used[r] = true;
+      roots.push_back(r);
+      neighbors.emplace_back();
+      for (node_t v : g.neighbors(r)) {
+        if (used[v]) continue;
+        used[v] = true;
+        neighbors.back().push_back(v);
+        if (neighbors.back().size() == kMaxBitParallelNeighbors) break;
+      }
+    }
+
+    num_bit_parallel_roots_ = roots.size();
+    bp_distances_.assign(std::size_t(num_nodes_) * num_bit_parallel_roots_, kInfinity);
+    bp_sets_.assign(std::size_t(num_nodes_) * num_bit_parallel_roots_, bit_parallel_sets{});
+    parallel_for(
+        roots.size(), 1,
+        fn(i, t [[maybe_unused]]) { bit_parallel_bfs(g, roots[i], neighbors[i], i); },
+        num_threads);
+  }
+
+  /// BFS from root |r| and its |neighbors| at once: for each node v, sets[v][0] (resp. [1])
+  /// holds neighbors u with d(u, v) = d(r, v) - 1 (resp. d(r, v))
+  void bit_parallel_bfs(const graph_type &g, node_t r, const std::vector<node_t> &neighbors,
+                        std::size_t i) {
+    std::vector<weight_type> dist(num_nodes_, kInfinity);
+    std::vector<bit_parallel_sets> sets(num_nodes_);
+    std::vector<node_t> queue;
+    std::vector<std::pair<node_t, node_t>> sibling_edges, child_edges;
+
+    dist[r] = 0;
+    queue.push_back(r);
+    for (std::size_t j : irange(neighbors.size())) {
+      dist[neighbors[j]] = 1;
+      sets[neighbors[j]][0] = std::uint64_t(1) << j;
+      queue.push_back(neighbors[j]);
+    }
+
+    std::size_t head = 0, tail = 1;  // current level is queue[head, tail)
+    for (weight_type d = 0; head < queue.size(); ++d) {
+      sibling_edges.clear();
+      child_edges.clear();
+      for (std::size_t k : irange(head, tail)) {
+        node_t v = queue[k];
+        for (node_t w : g.neighbors(v)) {
+          if (dist[w] < d) continue;
+          if (dist[w] == d) {
+            if (v < w) sibling_edges.emplace_back(v, w);
+          } else {
+            if (dist[w] == kInfinity) {
+              dist[w] = d + 1;
+              queue.push_back(w);
+            }
+            child_edges.emplace_back(v, w);
+          }
+        }
+      }
+      for (auto [v, w] : sibling_edges) {
+        sets[v][1] |= sets[w][0];
+        sets[w][1] |= sets[v][0];
+      }
+      for (auto [v, w] : child_edges) {
+        sets[w][0] |= sets[v][0];
+        sets[w][1] |= sets[v][1];
+      }
+      head = tail;
+      tail = queue.size();
+    }
+
+    const std::size_t k = num_bit_parallel_roots_;
+    for (node_t v : irange(num_nodes_)) {
+      bp_distances_[v * k + i] = dist[v];
+      bp_sets_[v * k + i] = sets[v];
+    }
+  }
+
+  /// run pruned searches from nodes in |order| (except |used| ones)
+  void build_labels(const graph_type &g, const graph_type &gt, const std::vector<node_t> &order,
+                    const std::vector<bool> &used) {
+    using entry_t = std::pair<node_t, weight_type>;
+    const int in = directed_ ? 1 : 0;
+    std::array<std::vector<std::vector<entry_t>>, 2> labels;
+    for (int i : irange(in + 1)) labels[i].resize(num_nodes_);
+    std::vector<weight_type> root_label(num_nodes_, kInfinity);  // indexed by rank
+    visitor_by_distance<graph_type> forward(g), backward(gt);
+
+    // search from |r| storing distances to |target| labels, pruned by |source| labels:
+    // forward search computes d(r, v) for in-labels of v, pruned by out-label of r and vice versa
+    auto pruned_search = [&](auto &visitor, node_t r, node_t rank, int source, int target) {
+      for (auto [h, d] : labels[source][r]) root_label[h] = d;
+      visitor.visit(r, fn(v, d) {
+        for (auto [h, dv] : labels[target][v]) {
+          if (root_label[h] != kInfinity && root_label[h] + dv <= d) return false;
+        }
+        if (num_bit_parallel_roots_ > 0 && bit_parallel_distance(r, v) <= d) return false;
+        labels[target][v].emplace_back(rank, d);
+        return true;
+      });
+      for (const auto &e : labels[source][r]) root_label[e.first] = kInfinity;
+    };
+
+    for (node_t rank : irange(num_nodes_)) {
+      node_t r = order[rank];
+      if (used[r]) continue;
+      pruned_search(forward, r, rank, 0, in);
+      if (directed_) pruned_search(backward, r, rank, in, 0);
+    }
+
+    // flatten into compact arrays
+    for (int i : irange(in + 1)) {
+      label_set &flat = labels_[i];
+      flat.offsets.assign(1, 0);
+      for (node_t v : irange(num_nodes_)) {
+        flat.offsets.push_back(flat.offsets.back() + labels[i][v].size());
+      }
+      flat.hubs.resize(flat.offsets.back());
+      flat.distances.resize(flat.offsets.back());
+      for (node_t v : irange(num_nodes_)) {
+        std::uint64_t offset = flat.offsets[v];
+        for (auto [h, d] : labels[i][v]) {
+          flat.hubs[offset] = h;
+          flat.distances[offset++] = d;
+        }
+        std::vector<entry_t>().swap(labels[i][v]);
+      }
+    }
+  }
+};
+}  // namespace bgl
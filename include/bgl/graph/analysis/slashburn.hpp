@@ -2,10 +2,12 @@
 #include "bgl/graph/visitor.hpp"
 #include <deque>
 
-/// [destructive] order by SlashBurn
 namespace bgl {
+/// compute SlashBurn ordering of |g| (hubs come last):
+/// return node permutation (i-th node of the ordering is |order[i]|) and the number of spokes.
+/// edge directions and weights are ignored, and any graph type including CSR graphs is accepted
 template <typename GraphType>
-node_t order_by_slashburn(GraphType &g, double r = 0.01) {
+std::pair<std::vector<node_t>, node_t> slashburn_ordering(const GraphType &g, double r = 0.01) {
   node_t k = std::ceil(r * g.num_nodes());
 
   // hub selection function
@@ -26,7 +28,14 @@ node_t order_by_slashburn(GraphType &g, double r = 0.01) {
     return order;
   };
 
-  GraphType gu = g.clone().make_undirected();
+  // undirected working copy (as |graph|, which supports node permutation and resizing)
+  unweighted_edge_list es;
+  es.reserve(g.num_edges());
+  for (node_t v : g.nodes()) {
+    for (node_t w : g.neighbors(v)) es.emplace_back(v, w);
+  }
+  graph gu(g.num_nodes(), es);
+  gu.make_undirected();
   std::deque<node_t> order_head, order_tail;
 
   std::vector<node_t> orig_id(g.num_nodes());
@@ -75,7 +84,7 @@ node_t order_by_slashburn(GraphType &g, double r = 0.01) {
     int current_ccid = 0;
     std::vector<int> ccid(n - k, -1);
     std::vector<node_t> ccsize;
-    visitor_by_distance<GraphType> visitor(gu);
+    visitor_by_distance<graph> visitor(gu);
 
     // compoute CCs
     for (node_t v : gu.nodes()) {
@@ -142,8 +151,14 @@ node_t order_by_slashburn(GraphType &g, double r = 0.01) {
   std::vector<node_t> order;
   order.insert(order.end(), order_head.begin(), order_head.end());
   order.insert(order.end(), order_tail.begin(), order_tail.end());
-  g.permute_nodes(order);
+  return {std::move(order), static_cast<node_t>(order_head.size())};
+}
 
-  return order_head.size();
+/// [destructive] order by SlashBurn
+template <typename GraphType>
+node_t order_by_slashburn(GraphType &g, double r = 0.01) {
+  auto [order, num_spokes] = slashburn_ordering(g, r);
+  g.permute_nodes(order);
+  return num_spokes;
 }
 }  // namespace bgl
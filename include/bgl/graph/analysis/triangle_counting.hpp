@@ -0,0 +1,142 @@
+#pragma once
+#include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/intersection.hpp"
+#include "bgl/util/all.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace bgl {
+/// parallel triangle counting on undirected simple graph (see |make_undirected| and |simplify|).
+/// each edge is oriented from the lower node to the higher node in the order of (degree, ID),
+/// and each triangle is found exactly once at its lowest node by intersecting the sorted
+/// out-neighbor lists of the ends of each out-edge (see |for_each_intersection|).
+/// the orientation bounds out-degrees by O(sqrt(m)), so hubs only have short lists and the total
+/// work is O(m^1.5) regardless of the degree distribution.
+/// @see "Finding, counting and listing all triangles in large graphs, an experimental study"
+///      (T. Schank and D. Wagner). In WEA'05.
+template <typename GraphType>
+class triangle_counter {
+public:
+  using graph_type = GraphType;
+
+  /// orient |g|: O(m)
+  /// @param g input undirected simple graph
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  triangle_counter(const graph_type &g, int num_threads = 0)
+      : num_threads_{num_threads}, offsets_(g.num_nodes() + 1) {
+    const node_t n = g.num_nodes();
+    auto precedes = fn(v, w) {
+      return g.outdegree(v) < g.outdegree(w) || (g.outdegree(v) == g.outdegree(w) && v < w);
+    };
+
+    offsets_[0] = 0;
+    g.for_each_node(
+        fn(v, t [[maybe_unused]]) {
+          std::uint64_t outdegree = 0;
+          for (node_t w : g.neighbors(v)) outdegree += precedes(v, w);
+          offsets_[v + 1] = outdegree;
+        },
+        num_threads_);
+    for (node_t v : irange(n)) offsets_[v + 1] += offsets_[v];
+
+    // adjacency lists are sorted, so are the filtered lists
+    heads_.resize(offsets_[n]);
+    g.for_each_node(
+        fn(v, t [[maybe_unused]]) {
+          std::uint64_t i = offsets_[v];
+          for (node_t w : g.neighbors(v)) {
+            if (precedes(v, w)) heads_[i++] = w;
+          }
+        },
+        num_threads_);
+  }
+
+  /// return the number of nodes
+  node_t num_nodes() const noexcept { return offsets_.size() - 1; }
+
+  /// return the number of triangles
+  std::uint64_t count() const {
+    std::vector<std::uint64_t> counts(std::max<int>(num_threads_, thread_pool::shared().size()));
+    for_each_node(fn(v, t) {
+      std::uint64_t count_v = 0;
+      for (node_t w : out_neighbors(v)) {
+        count_v += intersection_size(out_neighbors(v), out_neighbors(w));
+      }
+      counts[t] += count_v;
+    });
+    std::uint64_t result = 0;
+    for (std::uint64_t c : counts) result += c;
+    return result;
+  }
+
+  /// return the number of triangles including each node
+  std::vector<std::uint64_t> count_per_node() const {
+    std::vector<std::atomic<std::uint64_t>> counts(num_nodes());
+    parallel_for(
+        num_nodes(), kParallelUnit * 16,
+        fn(v, t [[maybe_unused]]) { counts[v].store(0, std::memory_order_relaxed); },
+        num_threads_);
+
+    // triangle (v, w, x) is found at |v|: count for |v| and |w| per list, and for |x| per node
+    for_each_node(fn(v, t [[maybe_unused]]) {
+      std::uint64_t count_v = 0;
+      for (node_t w : out_neighbors(v)) {
+        std::uint64_t count_w = 0;
+        for_each_intersection(out_neighbors(v), out_neighbors(w), fn(x, y [[maybe_unused]]) {
+          ++count_w;
+          counts[x].fetch_add(1, std::memory_order_relaxed);
+        });
+        if (count_w > 0) counts[w].fetch_add(count_w, std::memory_order_relaxed);
+        count_v += count_w;
+      }
+      if (count_v > 0) counts[v].fetch_add(count_v, std::memory_order_relaxed);
+    });
+
+    std::vector<std::uint64_t> result(num_nodes());
+    parallel_for(
+        num_nodes(), kParallelUnit * 16,
+        fn(v, t [[maybe_unused]]) { result[v] = counts[v].load(std::memory_order_relaxed); },
+        num_threads_);
+    return result;
+  }
+
+private:
+  static constexpr std::size_t kParallelUnit = 1024;
+
+  int num_threads_;
+  std::vector<std::uint64_t> offsets_;
+  std::vector<node_t> heads_;  // out-neighbors of oriented graph
+
+  edge_range<node_t> out_neighbors(node_t v) const noexcept {
+    return {heads_.data() + offsets_[v], heads_.data() + offsets_[v + 1]};
+  }
+
+  /// call |callback(v, t)| for each node balanced by the work of intersections
+  template <typename Callback>
+  void for_each_node(const Callback &callback) const {
+    parallel_for_weighted(
+        num_nodes(), kParallelUnit * 16,
+        fn(v) {
+          std::size_t d = offsets_[v + 1] - offsets_[v];
+          return 1 + d * d;
+        },
+        [&](std::size_t v, int t) { callback(static_cast<node_t>(v), t); }, num_threads_);
+  }
+};
+
+/// count triangles of undirected simple graph |g| in parallel (see |triangle_counter|)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::uint64_t count_triangles(const GraphType &g, int num_threads = 0) {
+  return triangle_counter<GraphType>(g, num_threads).count();
+}
+
+/// count triangles including each node of undirected simple graph |g| in parallel
+/// (see |triangle_counter|)
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::vector<std::uint64_t> count_triangles_per_node(const GraphType &g, int num_threads = 0) {
+  return triangle_counter<GraphType>(g, num_threads).count_per_node();
+}
+}  // namespace bgl
@@ -7,8 +7,8 @@
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <optional>
-#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -22,6 +22,9 @@ namespace bgl {
 /// type for representing node
 using node_t = std::uint32_t;
 
+/// node ID representing absence of node (e.g., parent of unreachable node)
+inline constexpr node_t kInvalidNode = std::numeric_limits<node_t>::max();
+
 
 /*
  * Edge type
@@ -79,6 +82,29 @@ bool compare_node_edge(node_t v, const EdgeType &e) {
   return v < to(e);
 }
 
+/// read-only view of contiguous edges (or other elements)
+template <typename EdgeType>
+class edge_range {
+public:
+  using value_type = EdgeType;
+  using const_iterator = const EdgeType *;
+
+  edge_range(const EdgeType *first, const EdgeType *last) : first_{first}, last_{last} {}
+
+  const EdgeType *begin() const noexcept { return first_; }
+  const EdgeType *end() const noexcept { return last_; }
+  const EdgeType *data() const noexcept { return first_; }
+  std::size_t size() const noexcept { return last_ - first_; }
+  bool empty() const noexcept { return first_ == last_; }
+  const EdgeType &operator[](std::size_t i) const noexcept { return first_[i]; }
+  const EdgeType &front() const noexcept { return *first_; }
+  const EdgeType &back() const noexcept { return *(last_ - 1); }
+
+private:
+  const EdgeType *first_;
+  const EdgeType *last_;
+};
+
 /// type for representing edge list
 template <typename EdgeType>
 using edge_list = std::vector<std::pair<node_t, EdgeType>>;
@@ -88,6 +114,10 @@ using unweighted_edge_list = edge_list<unweighted_edge_t>;
 template <typename WeightType>
 using weighted_edge_list = edge_list<weighted_edge_t<WeightType>>;
 
+/// type for representing read-only view of (a part of) edge list
+template <typename EdgeType>
+using edge_list_view = edge_range<std::pair<node_t, EdgeType>>;
+
 template <typename EdgeType>
 node_t num_nodes(const edge_list<EdgeType> &es) {
   node_t n = 0;
@@ -125,20 +155,71 @@ std::size_t num_edges(const adjacency_list<EdgeType> &adj) {
   return n;
 }
 
+/// split edge list into views of at most |chunk_size| edges (for parallel processing)
+template <typename EdgeType>
+std::vector<edge_list_view<EdgeType>> split_edge_list(const edge_list<EdgeType> &es,
+                                                       std::size_t chunk_size = 1 << 16) {
+  std::vector<edge_list_view<EdgeType>> views;
+  for (std::size_t i = 0; i < es.size(); i += chunk_size) {
+    std::size_t j = std::min(i + chunk_size, es.size());
+    views.emplace_back(es.data() + i, es.data() + j);
+  }
+  return views;
+}
+
+/// count outdegrees of edges in |views| in parallel
+template <typename EdgeType>
+std::vector<std::atomic<std::uint64_t>> count_outdegrees(
+    node_t num_nodes, const std::vector<edge_list_view<EdgeType>> &views, int num_threads = 0) {
+  std::vector<std::atomic<std::uint64_t>> degrees(num_nodes);
+  parallel_for(
+      views.size(), 1,
+      fn(i, t [[maybe_unused]]) {
+        for (const auto &e : views[i]) {
+          ASSERT_MSG(e.first < num_nodes, "invalid node index");
+          ASSERT_MSG(to(e.second) < num_nodes, "invalid node index");
+          degrees[e.first].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      num_threads);
+  return degrees;
+}
+
+/// convert edge lists (e.g., parsed by threads) to adjacency list by parallel counting sort
+template <typename EdgeType>
+adjacency_list<EdgeType> convert_to_adjacency_list(
+    node_t num_nodes, const std::vector<edge_list_view<EdgeType>> &views, int num_threads = 0) {
+  const std::size_t kParallelUnit = 1024;
+  auto cursors = count_outdegrees(num_nodes, views, num_threads);
+  adjacency_list<EdgeType> edges(num_nodes);
+  parallel_for(
+      num_nodes, kParallelUnit,
+      fn(v, t [[maybe_unused]]) {
+        edges[v].resize(cursors[v].load(std::memory_order_relaxed));
+        cursors[v].store(0, std::memory_order_relaxed);
+      },
+      num_threads);
+
+  parallel_for(
+      views.size(), 1,
+      fn(i, t [[maybe_unused]]) {
+        for (const auto &e : views[i]) {
+          edges[e.first][cursors[e.first].fetch_add(1, std::memory_order_relaxed)] = e.second;
+        }
+      },
+      num_threads);
+
+  parallel_for(
+      num_nodes, kParallelUnit,
+      fn(v, t [[maybe_unused]]) { std::sort(edges[v].begin(), edges[v].end()); }, num_threads);
+  return edges;
+}
+
 /// convert edge list to adjacency list
 template <typename EdgeType>
 adjacency_list<EdgeType> convert_to_adjacency_list(node_t num_nodes,
                                                    const edge_list<EdgeType> &es) {
-  adjacency_list<EdgeType> edges(num_nodes);
-  for (const auto &e : es) {
-    ASSERT_MSG(0 <= e.first && e.first < num_nodes, "invalid node index");
-    ASSERT_MSG(0 <= to(e.second) && to(e.second) < num_nodes, "invalid node index");
-    edges[e.first].push_back(e.second);
-  }
-  for (auto &es : edges) {
-    std::sort(es.begin(), es.end());
-  }
-  return edges;
+  return convert_to_adjacency_list(num_nodes, split_edge_list(es));
 }
 
 /// convert adjacency list to edge list
@@ -160,22 +241,45 @@ edge_list<EdgeType> convert_to_edge_list(const adjacency_list<EdgeType> &adj) {
  */
 
 template <typename Iterator>
-class neighbor_iterator : public Iterator {
+class neighbor_iterator {
 public:
-  neighbor_iterator(Iterator it) : Iterator{it} {}
-  node_t operator*() const noexcept { return to(*static_cast<const Iterator &>(*this)); }
+  using difference_type = std::ptrdiff_t;
+  using value_type = node_t;
+  using pointer = void;
+  using reference = node_t;
+  // remark: |operator*| returns a node by value, so this is not a forward iterator
+  using iterator_category = std::input_iterator_tag;
+  neighbor_iterator(Iterator it) : it_{it} {}
+  node_t operator*() const noexcept { return to(*it_); }
+  neighbor_iterator &operator++() noexcept {
+    ++it_;
+    return *this;
+  }
+  neighbor_iterator operator++(int) noexcept {
+    neighbor_iterator old = *this;
+    ++it_;
+    return old;
+  }
+  bool operator==(const neighbor_iterator &rhs) const noexcept { return it_ == rhs.it_; }
+  bool operator!=(const neighbor_iterator &rhs) const noexcept { return it_ != rhs.it_; }
+
+private:
+  Iterator it_;
 };
 
-/// neighbor adapter
+/// neighbor adapter: works on any contiguous edge array
 template <typename EdgeType>
 class neighbor_adapter {
 public:
-  neighbor_adapter(const std::vector<EdgeType> &edges) : edges_{edges} {}
-  auto begin() const { return neighbor_iterator{std::begin(edges_)}; }
-  auto end() const { return neighbor_iterator{std::end(edges_)}; }
+  neighbor_adapter(const std::vector<EdgeType> &edges)
+      : first_{edges.data()}, last_{edges.data() + edges.size()} {}
+  neighbor_adapter(const EdgeType *first, const EdgeType *last) : first_{first}, last_{last} {}
+  auto begin() const { return neighbor_iterator{first_}; }
+  auto end() const { return neighbor_iterator{last_}; }
 
 private:
-  const std::vector<EdgeType> &edges_;
+  const EdgeType *first_;
+  const EdgeType *last_;
 };
 
 /// Basic graph class: type for representing unweighted/weighted graph.
@@ -344,40 +448,19 @@ public:
   /* parallel for-each loop */
 
   /// parallel for-each loop
-  /// @param callback callback function (must be thread safe): argument is node ID
+  /// @param callback callback function (must be thread safe): arguments are node ID and thread ID
   /// @param num_threads the number of threads: when specified 0, set automatically
-  void for_each_node(std::function<void(node_t, int)> callback, int num_threads = 0) const {
-    std::atomic<int> counter = 0;
-    std::vector<std::thread> workers;
-    if (num_threads == 0) {
-      num_threads = std::min(std::thread::hardware_concurrency(),
-                             (num_nodes() + kParallelUnit - 1) / kParallelUnit);
-    }
-
-    for (int i : irange(num_threads)) {
-      workers.emplace_back(fn() {
-        while (true) {
-          int index = counter++;
-          node_t start = index * kParallelUnit;
-          node_t end = std::min((index + 1) * kParallelUnit, num_nodes());
-          for (node_t v : irange(start, end)) {
-            callback(v, i);
-          }
-          if (end == num_nodes()) return;
-        }
-      });
-    }
-
-    for (int i : irange(num_threads)) {
-      workers[i].join();
-    }
+  template <typename Callback>
+  void for_each_node(const Callback &callback, int num_threads = 0) const {
+    // chunks are balanced by the number of edges, so that hubs do not stall other nodes
+    std::size_t unit = kParallelUnit * (1 + num_edges() / std::max<node_t>(num_nodes(), 1));
+    parallel_for_weighted(
+        num_nodes(), unit, fn(v) { return 1 + outdegree(v); },
+        [&](std::size_t v, int i) { callback(static_cast<node_t>(v), i); }, num_threads);
   }
 
   /// return number of threads
-  int num_threads() const {
-    return std::min(std::thread::hardware_concurrency(),
-                    (num_nodes() + kParallelUnit - 1) / kParallelUnit);
-  }
+  int num_threads() const { return default_num_threads(num_nodes(), kParallelUnit); }
 
   /* graph conversion */
 
@@ -415,6 +498,13 @@ public:
     return *this;
   }
 
+  /// return transposed graph
+  graph_type transposed() const {
+    graph_type result = clone();
+    result.transpose();
+    return result;
+  }
+
   /// [destructive] make graph undirected
   graph_type &make_undirected() {
     std::vector<std::size_t> outdegrees(num_nodes());
@@ -0,0 +1,308 @@
+#pragma once
+#include "basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bgl {
+/// CSR graph class: immutable unweighted/weighted graph in compressed sparse row format.
+/// Internally, graph is stored as an offset array of size (n + 1) and one contiguous array of
+/// sorted edges, so that neighbor scans are sequential memory accesses.
+/// Since graph is immutable, copies share the same storage.
+template <typename EdgeType>
+class basic_csr_graph {
+public:
+  using edge_type = EdgeType;
+  using weight_type = decltype(weight(edge_type{}));
+  using graph_type = basic_csr_graph<EdgeType>;
+  using offset_type = std::uint64_t;
+
+  /* initialization */
+
+  /// default constructor
+  basic_csr_graph() : basic_csr_graph(std::vector<offset_type>{0}, {}) {}
+
+  /// construct with edge list
+  basic_csr_graph(const edge_list<edge_type> &es) : basic_csr_graph(bgl::num_nodes(es), es) {}
+
+  /// construct with edge list specifying the number of nodes
+  basic_csr_graph(node_t num_nodes, const edge_list<edge_type> &es)
+      : basic_csr_graph(num_nodes, split_edge_list(es)) {}
+
+  /// construct with edge lists (e.g., parsed by multiple threads) by parallel counting sort
+  basic_csr_graph(node_t num_nodes, const std::vector<edge_list_view<edge_type>> &views,
+                  int num_threads = 0) {
+    auto cursors = count_outdegrees(num_nodes, views, num_threads);
+    std::vector<offset_type> offsets(num_nodes + 1);
+    for (node_t v : irange(num_nodes)) {
+      offsets[v + 1] = offsets[v] + cursors[v].load(std::memory_order_relaxed);
+      cursors[v].store(offsets[v], std::memory_order_relaxed);
+    }
+
+    // counting sort by source node
+    std::vector<edge_type> edges(offsets.back());
+    parallel_for(
+        views.size(), 1,
+        fn(i, t [[maybe_unused]]) {
+          for (const auto &e : views[i]) {
+            edges[cursors[e.first].fetch_add(1, std::memory_order_relaxed)] = e.second;
+          }
+        },
+        num_threads);
+
+    parallel_for(
+        num_nodes, kParallelUnit,
+        fn(v, t [[maybe_unused]]) {
+          std::sort(edges.begin() + offsets[v], edges.begin() + offsets[v + 1]);
+        },
+        num_threads);
+
+    assign(std::move(offsets), std::move(edges));
+  }
+
+  /// construct with adjacency-list graph
+  basic_csr_graph(const basic_graph<edge_type> &g) {
+    std::vector<offset_type> offsets(g.num_nodes() + 1);
+    std::vector<edge_type> edges;
+    edges.reserve(g.num_edges());
+    for (node_t v : g.nodes()) {
+      edges.insert(edges.end(), g.edges(v).begin(), g.edges(v).end());
+      offsets[v + 1] = edges.size();
+    }
+    assign(std::move(offsets), std::move(edges));
+  }
+
+  /// construct with offset array and sorted edge array.
+  /// when edges of each node are not sorted, behavior is undefined.
+  /// |offsets| and |edges| must be rvalue
+  basic_csr_graph(std::vector<offset_type> &&offsets, std::vector<edge_type> &&edges) {
+    assign(std::move(offsets), std::move(edges));
+  }
+
+  /// construct view of external offset array and sorted edge array (e.g., memory-mapped file).
+  /// |storage| is an owner object that keeps both arrays alive during the lifetime of graph
+  basic_csr_graph(node_t num_nodes, const offset_type *offsets, const edge_type *edges,
+                  std::shared_ptr<const void> storage)
+      : storage_{std::move(storage)},
+        offsets_{offsets},
+        edges_{edges},
+        num_nodes_{num_nodes},
+        num_edges_{offsets[num_nodes]} {}
+
+  /// make clone (storage is shared)
+  graph_type clone() const { return *this; }
+
+  /// convert to adjacency-list graph
+  basic_graph<edge_type> to_basic_graph() const {
+    adjacency_list<edge_type> adj(num_nodes());
+    for (node_t v : nodes()) {
+      adj[v].assign(edges(v).begin(), edges(v).end());
+    }
+    return {num_nodes(), num_edges(), std::move(adj)};
+  }
+
+  /// return transposed graph
+  graph_type transposed() const {
+    std::vector<offset_type> offsets(num_nodes() + 1);
+    for (node_t v : nodes()) {
+      for (node_t w : neighbors(v)) {
+        ++offsets[w + 1];
+      }
+    }
+    for (node_t v : nodes()) {
+      offsets[v + 1] += offsets[v];
+    }
+
+    // edges of each node are automatically sorted since |v| is increasing
+    std::vector<offset_type> pos(offsets.begin(), offsets.end() - 1);
+    std::vector<edge_type> edges(num_edges());
+    for (node_t v : nodes()) {
+      for (const edge_type &e : this->edges(v)) {
+        edges[pos[to(e)]++] = update_to(e, v);
+      }
+    }
+
+    return {std::move(offsets), std::move(edges)};
+  }
+
+  /* basic operations */
+
+  /// equality operator
+  bool operator==(const graph_type &rhs) const noexcept {
+    return num_nodes_ == rhs.num_nodes_ && num_edges_ == rhs.num_edges_ &&
+           std::equal(offsets_, offsets_ + num_nodes_ + 1, rhs.offsets_) &&
+           std::equal(edges_, edges_ + num_edges_, rhs.edges_);
+  }
+
+  /// inequality operator
+  bool operator!=(const graph_type &rhs) const noexcept { return !(*this == rhs); }
+
+  /// return the number of nodes
+  node_t num_nodes() const noexcept { return num_nodes_; };
+
+  /// return the number of **directed** edges
+  std::size_t num_edges() const noexcept { return num_edges_; };
+
+  /// determine whether graph is empty
+  bool empty() const noexcept { return num_nodes() == 0; }
+
+  /// return outdegree of node |v|
+  std::size_t outdegree(node_t v) const noexcept { return offsets_[v + 1] - offsets_[v]; };
+
+  /// useful adapter of nodes for range-based for-loop
+  irange_type<node_t> nodes() const noexcept { return irange(num_nodes()); };
+
+  /// return an edge from node |v| of index |i|
+  const edge_type &edge(node_t v, std::size_t i) const noexcept {
+    return edges_[offsets_[v] + i];
+  };
+
+  /// return edge list from node |v|
+  edge_range<edge_type> edges(node_t v) const noexcept {
+    return {edges_ + offsets_[v], edges_ + offsets_[v + 1]};
+  };
+
+  /// return a neighbor from node |v| of index |i|
+  node_t neighbor(node_t v, std::size_t i) const noexcept { return to(edge(v, i)); }
+
+  /// useful adapter of neighbors for range-based for-loop
+  neighbor_adapter<edge_type> neighbors(node_t v) const noexcept {
+    return {edges_ + offsets_[v], edges_ + offsets_[v + 1]};
+  };
+
+  /// return offset array (of size n + 1)
+  const offset_type *offsets() const noexcept { return offsets_; }
+
+  /// return pointer to the first edge (edges of all nodes are stored contiguously)
+  const edge_type *edge_data() const noexcept { return edges_; }
+
+  /// check if there exists an edge from |u| to |v|
+  bool is_adjacent(node_t u, node_t v) const noexcept { return get_weight(u, v).has_value(); }
+
+  /// get (smallest) weight of edge from |u| to |v|.
+  /// if |u| and |v| are not adjacent, return nullopt
+  std::optional<weight_type> get_weight(node_t u, node_t v) const noexcept {
+    const auto es = edges(u);
+    const auto it = std::lower_bound(es.begin(), es.end(), v, compare_edge_node<edge_type>);
+    if (it == es.end() || to(*it) != v) {
+      return std::nullopt;
+    }
+    return weight(*it);
+  }
+
+  /// get edge list of the graph
+  edge_list<edge_type> get_edge_list() const {
+    edge_list<edge_type> es;
+    es.reserve(num_edges());
+    for (node_t v : nodes()) {
+      for (const auto &e : edges(v)) {
+        es.emplace_back(v, e);
+      }
+    }
+    return es;
+  }
+
+  /* parallel for-each loop */
+
+  /// parallel for-each loop
+  /// @param callback callback function (must be thread safe): arguments are node ID and thread ID
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  template <typename Callback>
+  void for_each_node(const Callback &callback, int num_threads = 0) const {
+    // chunks are balanced by the number of edges, so that hubs do not stall other nodes
+    std::size_t unit = kParallelUnit * (1 + num_edges() / std::max<node_t>(num_nodes(), 1));
+    parallel_for_weighted(
+        num_nodes(), unit, fn(v) { return 1 + outdegree(v); },
+        [&](std::size_t v, int i) { callback(static_cast<node_t>(v), i); }, num_threads);
+  }
+
+  /// return number of threads
+  int num_threads() const { return default_num_threads(num_nodes(), kParallelUnit); }
+
+  /* pretty print */
+
+  /// do pretty print to |os|
+  void pretty_print(std::ostream &os = std::cerr) const {
+    const node_t kLimitNumNodes = 5;
+    const std::size_t kLimitNumEdges = 10;
+
+    fmt::print(os, "====================\n");
+    fmt::print(os, "  # of nodes: {}\n", commify(num_nodes()));
+    fmt::print(os, "  # of edges: {}\n", commify(num_edges()));
+    fmt::print(os, "  weight type: {}\n", weight_string());
+    fmt::print(os, "  storage: csr\n");
+    fmt::print(os, "--------------------\n");
+    for (node_t v : irange(std::min(num_nodes(), kLimitNumNodes))) {
+      fmt::print(os, "  {} -> ", v);
+      for (std::size_t i : irange(std::min(outdegree(v), kLimitNumEdges))) {
+        if (i > 0) fmt::print(os, ", ");
+        fmt::print(os, "{}", edge(v, i));
+      }
+      if (outdegree(v) > kLimitNumEdges) fmt::print(os, ", ...");
+      fmt::print(os, "\n");
+    }
+    if (num_nodes() > kLimitNumNodes) fmt::print(os, "  ...\n");
+    fmt::print(os, "====================\n");
+  }
+
+  /* weight information */
+
+  std::string weight_string() const {
+    if (std::is_same_v<edge_type, unweighted_edge_t>) return "unweighted";
+    return typename_of(weight_type{});
+  }
+
+  std::size_t weight_sizeof() const {
+    if (std::is_same_v<edge_type, unweighted_edge_t>) return 0;
+    return sizeof(weight_type);
+  }
+
+private:
+  struct storage {
+    std::vector<offset_type> offsets;
+    std::vector<edge_type> edges;
+  };
+
+  std::shared_ptr<const void> storage_;
+  const offset_type *offsets_;
+  const edge_type *edges_;
+  node_t num_nodes_;
+  std::size_t num_edges_;
+  static const node_t kParallelUnit = 1024;
+
+  void assign(std::vector<offset_type> &&offsets, std::vector<edge_type> &&edges) {
+    ASSERT_MSG(!offsets.empty() && offsets.back() == edges.size(), "invalid offset array");
+    auto s = std::make_shared<storage>(storage{std::move(offsets), std::move(edges)});
+    offsets_ = s->offsets.data();
+    edges_ = s->edges.data();
+    num_nodes_ = s->offsets.size() - 1;
+    num_edges_ = s->edges.size();
+    storage_ = std::move(s);
+  }
+};
+
+/// determine whether |GraphType| is a CSR graph type
+template <typename GraphType>
+struct is_csr_graph : std::false_type {};
+
+template <typename EdgeType>
+struct is_csr_graph<basic_csr_graph<EdgeType>> : std::true_type {};
+
+template <typename GraphType>
+inline constexpr bool is_csr_graph_v = is_csr_graph<GraphType>::value;
+
+/// specialized type for representing unweighted CSR graph
+using csr_graph = basic_csr_graph<unweighted_edge_t>;
+
+/// specialized type for representing weighted CSR graph
+template <typename WeightType>
+using csr_wgraph = basic_csr_graph<weighted_edge_t<WeightType>>;
+}  // namespace bgl
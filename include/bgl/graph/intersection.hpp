@@ -0,0 +1,149 @@
+#pragma once
+#include "basic_graph.hpp"
+#include "bgl/util/all.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+namespace bgl {
+/// return the first position of sorted edges [|first|, |last|) whose node is not less than
+/// |value| by galloping (exponential search) from |first|: O(log(distance))
+template <typename Iterator>
+Iterator gallop(Iterator first, Iterator last, node_t value) {
+  if (first == last || to(*first) >= value) return first;
+  // invariant: to(*first) < value
+  std::ptrdiff_t step = 1;
+  while (step < last - first && to(first[step]) < value) {
+    first += step;
+    step *= 2;
+  }
+  last = first + std::min(step, last - first);
+  return std::lower_bound(first + 1, last, value, fn(e, v) { return to(e) < v; });
+}
+
+/// call |callback(x, y)| for each pair of elements with the same node of sorted edges
+/// [|x_first|, |x_last|) and [|y_first|, |y_last|) by searching nodes of the former in the
+/// latter by galloping: O(|x| * log(|y| / |x|))
+template <typename EdgeTypeX, typename EdgeTypeY, typename Callback>
+void gallop_intersection(const EdgeTypeX *x_first, const EdgeTypeX *x_last,
+                         const EdgeTypeY *y_first, const EdgeTypeY *y_last,
+                         const Callback &callback) {
+  for (; x_first != x_last && y_first != y_last; ++x_first) {
+    y_first = gallop(y_first, y_last, to(*x_first));
+    if (y_first != y_last && to(*y_first) == to(*x_first)) callback(*x_first, *y_first++);
+  }
+}
+
+#ifdef __AVX2__
+/// compare sorted nodes |x| and |y| by blocks of 8 nodes from |x[i]| and |y[j]| while both have a
+/// full block: all pairs of two blocks are compared by rotating the block of |y| 7 times.
+/// |callback(k, mask)| is called for each pair of blocks, where bit l of |mask| is set if
+/// |x[k + l]| is in the block of |y|. |i| and |j| are advanced to the remaining nodes
+template <typename Callback>
+void intersect_blocks_avx2(const node_t *x, std::size_t nx, const node_t *y, std::size_t ny,
+                           std::size_t &i, std::size_t &j, const Callback &callback) {
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  while (i + 8 <= nx && j + 8 <= ny) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + j));
+    __m256i eq = _mm256_cmpeq_epi32(a, b);
+    for (int r = 1; r < 8; ++r) {
+      b = _mm256_permutevar8x32_epi32(b, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, b));
+    }
+    callback(i, _mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    // the block with the smaller last node cannot match the following blocks of the other
+    const node_t x_last = x[i + 7], y_last = y[j + 7];
+    if (x_last <= y_last) i += 8;
+    if (y_last <= x_last) j += 8;
+  }
+}
+#endif
+
+/// call |callback(x, y)| for each pair of elements |x| of |xs| and |y| of |ys| with the same node
+/// in increasing order of node.
+/// |xs| and |ys| are contiguous ranges (e.g., |std::vector| and |edge_range|) of unweighted or
+/// weighted edges sorted by node without duplicates, such as adjacency lists of simple graph.
+/// when one list is much shorter than the other, nodes of the shorter list are searched in the
+/// longer one by galloping: O(min * log(max / min)). otherwise, two lists are merged, where
+/// unweighted lists are compared by blocks of 8x8 nodes with AVX2.
+/// @see "SIMD compression and the intersection of sorted integers"
+///      (D. Lemire, L. Boytsov and N. Kurz). Software: Practice and Experience, 2016.
+template <typename RangeX, typename RangeY, typename Callback>
+void for_each_intersection(const RangeX &xs, const RangeY &ys, const Callback &callback) {
+  using x_type = std::decay_t<decltype(*std::data(xs))>;
+  using y_type = std::decay_t<decltype(*std::data(ys))>;
+  constexpr std::size_t kGallopRatio = 32;
+  const x_type *x = std::data(xs);
+  const y_type *y = std::data(ys);
+  const std::size_t nx = std::size(xs), ny = std::size(ys);
+
+  if (nx * kGallopRatio < ny) {
+    gallop_intersection(x, x + nx, y, y + ny, callback);
+    return;
+  }
+  if (ny * kGallopRatio < nx) {
+    gallop_intersection(y, y + ny, x, x + nx, fn(b, a) { callback(a, b); });
+    return;
+  }
+
+  std::size_t i = 0, j = 0;
+#ifdef __AVX2__
+  if constexpr (std::is_same_v<x_type, node_t> && std::is_same_v<y_type, node_t>) {
+    intersect_blocks_avx2(x, nx, y, ny, i, j, fn(k, mask) {
+      for (int m = mask; m != 0; m &= m - 1) {
+        const node_t v = x[k + __builtin_ctz(m)];
+        callback(v, v);
+      }
+    });
+  }
+#endif
+  while (i < nx && j < ny) {
+    if (to(x[i]) < to(y[j])) {
+      ++i;
+    } else if (to(y[j]) < to(x[i])) {
+      ++j;
+    } else {
+      callback(x[i++], y[j++]);
+    }
+  }
+}
+
+/// return the number of common nodes of sorted edge lists |xs| and |ys|
+/// (see |for_each_intersection|)
+template <typename RangeX, typename RangeY>
+std::size_t intersection_size(const RangeX &xs, const RangeY &ys) {
+  using x_type = std::decay_t<decltype(*std::data(xs))>;
+  using y_type = std::decay_t<decltype(*std::data(ys))>;
+  std::size_t result = 0;
+  std::size_t i = 0, j = 0;
+#ifdef __AVX2__
+  // count matches of blocks by popcount
+  if constexpr (std::is_same_v<x_type, node_t> && std::is_same_v<y_type, node_t>) {
+    const std::size_t nx = std::size(xs), ny = std::size(ys);
+    if (nx <= ny * 32 && ny <= nx * 32) {
+      intersect_blocks_avx2(std::data(xs), nx, std::data(ys), ny, i, j,
+                            fn(k [[maybe_unused]], mask) { result += __builtin_popcount(mask); });
+    }
+  }
+#endif
+  for_each_intersection(edge_range<x_type>(std::data(xs) + i, std::data(xs) + std::size(xs)),
+                        edge_range<y_type>(std::data(ys) + j, std::data(ys) + std::size(ys)),
+                        fn(a [[maybe_unused]], b [[maybe_unused]]) { ++result; });
+  return result;
+}
+
+/// store common nodes of sorted edge lists |xs| and |ys| to |out| in increasing order
+/// (see |for_each_intersection|)
+template <typename RangeX, typename RangeY>
+void intersection(const RangeX &xs, const RangeY &ys, std::vector<node_t> &out) {
+  out.clear();
+  for_each_intersection(xs, ys, fn(a, b [[maybe_unused]]) { out.push_back(to(a)); });
+}
+}  // namespace bgl
@@ -1,11 +1,19 @@
 #pragma once
 #include "basic_graph.hpp"
+#include "csr_graph.hpp"
 #include "bgl/util/all.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -30,26 +38,115 @@ void write_edge_tsv(std::ostream &os, const weighted_edge_t<WeightType> &e) {
   fmt::print(os, "{} {}", to(e), weight(e));
 }
 
-/// read graph from |is| as tsv file
-/// when type does not match and |accept_mismatch|, return |nullopt|
-template <typename GraphType>
-std::optional<GraphType> read_graph_tsv_optional(std::istream &is, bool accept_mismatch = false) {
-  using edge_t = typename GraphType::edge_type;
-  ASSERT_MSG(is, "empty stream");
+/// parse a number in [|first|, |last|) after skipping spaces and tabs.
+/// return pointer to the character following the number, or |nullptr| on failure
+template <typename T>
+const char *parse_tsv_value(const char *first, const char *last, T &value) {
+  while (first != last && (*first == ' ' || *first == '\t')) ++first;
+  if (first != last && *first == '+') ++first;
+  auto [ptr, ec] = std::from_chars(first, last, value);
+  return ec == std::errc{} ? ptr : nullptr;
+}
 
-  std::string line;
-  edge_list<edge_t> es;
-  bool type_checked = false;
+inline const char *parse_edge_tsv(const char *first, const char *last, unweighted_edge_t &e) {
+  return parse_tsv_value(first, last, e);
+}
+
+template <typename WeightType>
+const char *parse_edge_tsv(const char *first, const char *last, weighted_edge_t<WeightType> &e) {
+  first = parse_tsv_value(first, last, e.first);
+  return first == nullptr ? nullptr : parse_tsv_value(first, last, e.second);
+}
+
+/// result of parsing a chunk of tsv file (consisting of whole lines)
+template <typename EdgeType>
+struct tsv_chunk {
+  edge_list<EdgeType> es;
+  node_t num_nodes = 0;
+  std::size_t num_lines = 0;
+  std::vector<std::string> type_strings;  // weight types declared in comments
+  std::optional<std::pair<std::size_t, std::string>> failure;  // (line index, line)
+};
+
+/// parse lines in [|first|, |last|) as tsv file.
+/// parsing stops at the first line that cannot be read
+template <typename EdgeType>
+tsv_chunk<EdgeType> parse_tsv_chunk(const char *first, const char *last) {
+  static const std::string_view type_comment = "# weight type: ";
+  tsv_chunk<EdgeType> chunk;
+
+  for (; first != last; ++chunk.num_lines) {
+    const void *newline = std::memchr(first, '\n', last - first);
+    const char *eol = newline == nullptr ? last : static_cast<const char *>(newline);
+    const char *next = newline == nullptr ? last : eol + 1;
+    if (eol != first && eol[-1] == '\r') --eol;
+    std::string_view line(first, eol - first);
+    first = next;
+
+    if (line.substr(0, type_comment.size()) == type_comment) {
+      chunk.type_strings.emplace_back(line.substr(type_comment.size()));
+    }
+
+    if (line.empty() || line[0] == '#') continue;
 
-  for (std::size_t lineno = 1; std::getline(is, line); ++lineno) {
     node_t v;
-    edge_t e;
+    EdgeType e;
+    const char *p = parse_tsv_value(line.data(), eol, v);
+    if (p != nullptr) p = parse_edge_tsv(p, eol, e);
+    if (p == nullptr) {
+      chunk.failure.emplace(chunk.num_lines, line);
+      break;
+    }
+
+    chunk.es.emplace_back(v, e);
+    chunk.num_nodes = std::max(chunk.num_nodes, std::max(v, to(e)) + 1);
+  }
+
+  return chunk;
+}
+
+/// size of a chunk of tsv content parsed by one thread [byte]
+const std::size_t kTsvChunkSize = 1 << 22;
 
-    // weight type check
-    static const std::string type_comment = "# weight type: ";
-    if (line.compare(0, type_comment.size(), type_comment) == 0) {
-      std::string type_string = line.substr(type_comment.size());
-      std::string read_as = GraphType{}.weight_string();
+/// split tsv content [|data|, |data| + |size|) into chunks of about |kTsvChunkSize| bytes at line
+/// boundaries, parse them in parallel, and append the results to |chunks|
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename EdgeType>
+void parse_tsv_chunks(const char *data, std::size_t size,
+                      std::vector<tsv_chunk<EdgeType>> &chunks, int num_threads = 0) {
+  const char *last = data + size;
+  std::vector<const char *> bounds = {data};
+  while (bounds.back() != last) {
+    const char *p = bounds.back() + std::min<std::size_t>(kTsvChunkSize, last - bounds.back());
+    const void *newline = std::memchr(p, '\n', last - p);
+    bounds.push_back(newline == nullptr ? last : static_cast<const char *>(newline) + 1);
+  }
+
+  const std::size_t offset = chunks.size();
+  chunks.resize(offset + bounds.size() - 1);
+  parallel_for(
+      bounds.size() - 1, 1,
+      fn(i, t [[maybe_unused]]) {
+        chunks[offset + i] = parse_tsv_chunk<EdgeType>(bounds[i], bounds[i + 1]);
+      },
+      num_threads);
+}
+
+/// check parsed |chunks| in order of lines and build graph by parallel counting sort.
+/// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::optional<GraphType> build_graph_from_tsv_chunks(
+    const std::vector<tsv_chunk<typename GraphType::edge_type>> &chunks, bool accept_mismatch,
+    int num_threads = 0) {
+  using edge_t = typename GraphType::edge_type;
+  const std::string read_as = GraphType{}.weight_string();
+  bool type_checked = false;
+  std::size_t lineno = 1;
+  node_t n = 0;
+  std::size_t m = 0;
+  for (const auto &chunk : chunks) {
+    for (const auto &type_string : chunk.type_strings) {
       if (accept_mismatch && type_string != read_as) {
         return std::nullopt;
       }
@@ -59,30 +156,86 @@ std::optional<GraphType> read_graph_tsv_optional(std::istream &is, bool accept_m
       type_checked = true;
     }
 
-    if (line.empty() || line[0] == '#') continue;
-
-    std::stringstream ss(line);
-    bool read_success = static_cast<bool>(ss >> v >> e);
-    if (!read_success && accept_mismatch && !type_checked) {
+    if (chunk.failure && accept_mismatch && !type_checked) {
       return std::nullopt;
     }
+    ASSERT_MSG(!chunk.failure, "read failed at line {}\n  read: {}\n  weight type: {}",
+               lineno + chunk.failure->first, chunk.failure->second, read_as);
 
-    ASSERT_MSG(read_success, "read failed at line {}\n  read: {}\n  weight type: {}", lineno, line,
-               GraphType{}.weight_string());
+    lineno += chunk.num_lines;
+    n = std::max(n, chunk.num_nodes);
+    m += chunk.es.size();
+  }
 
-    es.emplace_back(v, e);
+  std::vector<edge_list_view<edge_t>> views;
+  for (const auto &chunk : chunks) {
+    views.emplace_back(chunk.es.data(), chunk.es.data() + chunk.es.size());
   }
 
-  return GraphType(es);
+  if constexpr (is_csr_graph_v<GraphType>) {
+    return GraphType(n, views, num_threads);
+  } else {
+    return GraphType(n, m, convert_to_adjacency_list(n, views, num_threads));
+  }
 }
 
-/// read graph from |filename| as tsv file
+/// read graph from tsv content [|data|, |data| + |size|) using multiple threads.
+/// content is split into chunks at line boundaries, which are parsed in parallel,
+/// and then the graph is built by parallel counting sort.
+/// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::optional<GraphType> parse_graph_tsv_optional(const char *data, std::size_t size,
+                                                  bool accept_mismatch = false,
+                                                  int num_threads = 0) {
+  std::vector<tsv_chunk<typename GraphType::edge_type>> chunks;
+  parse_tsv_chunks(data, size, chunks, num_threads);
+  return build_graph_from_tsv_chunks<GraphType>(chunks, accept_mismatch, num_threads);
+}
+
+/// read graph from |is| as tsv file.
+/// input is read by batches of |kTsvChunkSize| bytes per thread, and each batch is parsed in
+/// parallel up to its last line break (the partial line is carried over to the next batch),
+/// so that memory for the raw text does not depend on the size of input.
+/// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+std::optional<GraphType> read_graph_tsv_optional(std::istream &is, bool accept_mismatch = false,
+                                                 int num_threads = 0) {
+  ASSERT_MSG(is, "empty stream");
+  const int threads = num_threads > 0 ? num_threads : thread_pool::shared().size();
+  const std::size_t batch_size = kTsvChunkSize * threads;
+  std::vector<tsv_chunk<typename GraphType::edge_type>> chunks;
+  std::string buf;
+  while (is) {
+    const std::size_t carried = buf.size();
+    buf.resize(carried + batch_size);
+    is.read(buf.data() + carried, batch_size);
+    buf.resize(carried + is.gcount());
+
+    // at the end of input, the remaining partial line is also parsed
+    std::size_t end = buf.size();
+    if (is) {
+      std::size_t newline = buf.rfind('\n');
+      end = newline == std::string::npos ? 0 : newline + 1;
+    }
+    if (end > 0) {
+      parse_tsv_chunks(buf.data(), end, chunks, num_threads);
+      buf.erase(0, end);
+    }
+  }
+  return build_graph_from_tsv_chunks<GraphType>(chunks, accept_mismatch, num_threads);
+}
+
+/// read graph from |filename| as tsv file (file is memory-mapped)
 /// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
 template <typename GraphType>
-std::optional<GraphType> read_graph_tsv_optional(const path &file, bool accept_mismatch = false) {
-  std::ifstream ifs(file.string());
-  ASSERT_MSG(ifs, "file does not exist: {}", file);
-  return read_graph_tsv_optional<GraphType>(ifs, accept_mismatch);
+std::optional<GraphType> read_graph_tsv_optional(const path &file, bool accept_mismatch = false,
+                                                 int num_threads = 0) {
+  mapped_file mf(file);
+  mf.advise_sequential();
+  return parse_graph_tsv_optional<GraphType>(mf.data(), mf.size(), accept_mismatch, num_threads);
 }
 
 /// read graph from |is| as tsv file
@@ -128,7 +281,7 @@ void write_graph_tsv(const path &filename, const GraphType &g, bool write_info =
 /* binary I/O */
 
 /*
- *  binary format specification:
+ *  binary format specification (version 1):
  *    - 4 bytes: magic constant: "bgl\0"
  *    - 4 bytes: weight size [byte]
  *    - 4 bytes: whether weight type is integral (0 or 1; 1 when unweighted)
@@ -139,8 +292,26 @@ void write_graph_tsv(const path &filename, const GraphType &g, bool write_info =
  *        + repeat (outdegree) times:
  *            - 4 bytes: connected node (sorted)
  *            - (weight size) bytes: edge weight
+ *
+ *  binary format specification (version 2):
+ *    - 4 bytes: magic constant: "bgl\0"
+ *    - 4 bytes: format version with the most significant bit set (0x80000002)
+ *    - 4 bytes: weight size [byte]
+ *    - 4 bytes: whether weight type is integral (0 or 1; 1 when unweighted)
+ *    - 4 bytes: the number of nodes (n)
+ *    - 4 bytes: edge size [byte] (including padding of edge type)
+ *    - 8 bytes: the number of edges (m)
+ *    - 8 * (n + 1) bytes: offset table: edges from node v are edges[offsets[v], offsets[v + 1])
+ *    - zero padding up to 64-byte boundary
+ *    - (edge size) * m bytes: edge array (sorted for each node)
+ *
+ *  the second field of version 1 (weight size) never has the most significant bit set.
+ *  version 2 keeps edges in one contiguous array, so that the file can be memory-mapped.
  */
 
+inline constexpr std::uint32_t kBinaryVersionFlag = 0x80000000u;
+inline constexpr std::uint64_t kBinaryAlignment = 64;
+
 template <typename T>
 T read_binary(std::istream &is) {
   T t{};
@@ -153,15 +324,32 @@ void write_binary(std::ostream &os, const T &t) {
   os.write(reinterpret_cast<const char *>(&t), sizeof(T));
 }
 
-/// read graph from |is| in binary format .
+/// header of graph file in binary format
+struct binary_header {
+  std::uint32_t version = 1;
+  std::uint32_t weight_size = 0;
+  bool is_integral = true;
+  node_t num_nodes = 0;
+  std::uint32_t edge_size = 0;
+  std::uint64_t num_edges = 0;
+
+  /// [version 2] position of offset table [byte]
+  std::uint64_t offsets_position() const { return 32; }
+
+  /// [version 2] position of edge array [byte]
+  std::uint64_t edges_position() const {
+    std::uint64_t end = offsets_position() + 8 * (std::uint64_t(num_nodes) + 1);
+    return (end + kBinaryAlignment - 1) / kBinaryAlignment * kBinaryAlignment;
+  }
+};
+
+/// read header of binary graph file from |is|.
 /// when type does not match and |accept_mismatch|, return |nullopt|
 template <typename GraphType>
-std::optional<GraphType> read_graph_binary_optional(std::istream &is,
-                                                    bool accept_mismatch = false) {
+std::optional<binary_header> read_binary_header(std::istream &is, bool accept_mismatch = false) {
   using edge_t = typename GraphType::edge_type;
   using weight_t = decltype(weight(edge_t{}));
-  static_assert(std::is_arithmetic_v<weight_t>, "edge weight must be arithmetic type");
-  ASSERT_MSG(is, "empty stream");
+  binary_header header;
 
   // check header
   char buf[4];
@@ -169,11 +357,19 @@ std::optional<GraphType> read_graph_binary_optional(std::istream &is,
   ASSERT_MSG(is.gcount() == 4 && buf[0] == 'b' && buf[1] == 'g' && buf[2] == 'l' && buf[3] == '\0',
              "invalid header");
 
+  // check version
+  header.weight_size = read_binary<std::uint32_t>(is);
+  if (header.weight_size & kBinaryVersionFlag) {
+    header.version = header.weight_size & ~kBinaryVersionFlag;
+    header.weight_size = read_binary<std::uint32_t>(is);
+  }
+  ASSERT_MSG(header.version == 1 || header.version == 2, "unsupported version: {}",
+             header.version);
+
   // check weight type
-  std::uint32_t edge_size = read_binary<std::uint32_t>(is);
-  bool is_integral = read_binary<std::uint32_t>(is);
-  bool type_matched =
-      edge_size == GraphType{}.weight_sizeof() && is_integral == std::is_integral_v<weight_t>;
+  header.is_integral = read_binary<std::uint32_t>(is);
+  bool type_matched = header.weight_size == GraphType{}.weight_sizeof() &&
+                      header.is_integral == std::is_integral_v<weight_t>;
 
   if (accept_mismatch && !type_matched) {
     return std::nullopt;
@@ -182,34 +378,286 @@ std::optional<GraphType> read_graph_binary_optional(std::istream &is,
   ASSERT_MSG(type_matched,
              "type of edge weight does not match\n  read as: {}\n"
              "  input type: size = {} byte(s), is_integral = {}",
-             GraphType{}.weight_string(), edge_size, is_integral);
+             GraphType{}.weight_string(), header.weight_size, header.is_integral);
+
+  header.num_nodes = read_binary<node_t>(is);
+  if (header.version == 1) {
+    header.edge_size = sizeof(edge_t);
+  } else {
+    header.edge_size = read_binary<std::uint32_t>(is);
+    ASSERT_MSG(header.edge_size == sizeof(edge_t), "edge size does not match: {} (expected: {})",
+               header.edge_size, sizeof(edge_t));
+  }
+  header.num_edges = read_binary<std::uint64_t>(is);
+  ASSERT_MSG(is, "read failed (invalid bgl file)");
+
+  return header;
+}
+
+/// determine whether offset table [|offsets|, |offsets| + |num_nodes| + 1) starts at 0, is
+/// non-decreasing, and ends at |num_edges|, i.e., every edge range is within the edge array
+inline bool is_valid_offset_table(const std::uint64_t *offsets, node_t num_nodes,
+                                  std::uint64_t num_edges) {
+  if (offsets[0] != 0 || offsets[num_nodes] != num_edges) return false;
+  std::atomic<bool> valid = true;
+  parallel_for(
+      num_nodes, 1 << 16,
+      fn(v, t [[maybe_unused]]) {
+        if (offsets[v] > offsets[v + 1]) valid.store(false, std::memory_order_relaxed);
+      });
+  return valid.load(std::memory_order_relaxed);
+}
+
+/// read graph from |is| in binary format .
+/// when type does not match and |accept_mismatch|, return |nullopt|
+template <typename GraphType>
+std::optional<GraphType> read_graph_binary_optional(std::istream &is,
+                                                    bool accept_mismatch = false) {
+  using edge_t = typename GraphType::edge_type;
+  using weight_t = decltype(weight(edge_t{}));
+  static_assert(std::is_arithmetic_v<weight_t>, "edge weight must be arithmetic type");
+  ASSERT_MSG(is, "empty stream");
+
+  std::optional<binary_header> header = read_binary_header<GraphType>(is, accept_mismatch);
+  if (!header.has_value()) {
+    return std::nullopt;
+  }
+
+  // offset table
+  node_t num_nodes = header->num_nodes;
+  std::uint64_t num_edges = header->num_edges;
+  std::vector<std::uint64_t> offsets(num_nodes + 1);
+  if (header->version == 2) {
+    is.read(reinterpret_cast<char *>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+    is.ignore(header->edges_position() - header->offsets_position() -
+              offsets.size() * sizeof(std::uint64_t));
+    ASSERT_MSG(is && is_valid_offset_table(offsets.data(), num_nodes, num_edges),
+               "read failed (invalid bgl file)");
+  }
 
   // graph body
-  node_t num_nodes = read_binary<node_t>(is);
-  std::uint64_t num_edges = read_binary<std::uint64_t>(is);
-  adjacency_list<edge_t> adj(num_nodes);
-  for (node_t v : irange(num_nodes)) {
-    std::uint64_t degree = read_binary<std::uint64_t>(is);
-    adj[v].resize(degree);
-    if (degree > 0) {
-      is.read(reinterpret_cast<char *>(adj[v].data()), degree * sizeof(edge_t));
+  auto read_degree = fn(v) {
+    if (header->version == 1) {
+      std::uint64_t degree = read_binary<std::uint64_t>(is);
+      offsets[v + 1] = offsets[v] + degree;
+    }
+    return offsets[v + 1] - offsets[v];
+  };
+
+  std::optional<GraphType> result;
+  if constexpr (is_csr_graph_v<GraphType>) {
+    std::vector<edge_t> edges(num_edges);
+    if (header->version == 1) {
+      for (node_t v : irange(num_nodes)) {
+        std::uint64_t degree = read_degree(v);
+        ASSERT_MSG(offsets[v + 1] <= num_edges, "read failed (invalid bgl file)");
+        if (degree > 0) {
+          is.read(reinterpret_cast<char *>(edges.data() + offsets[v]), degree * sizeof(edge_t));
+        }
+      }
+    } else {
+      is.read(reinterpret_cast<char *>(edges.data()), num_edges * sizeof(edge_t));
     }
+    result.emplace(std::move(offsets), std::move(edges));
+  } else {
+    adjacency_list<edge_t> adj(num_nodes);
+    for (node_t v : irange(num_nodes)) {
+      std::uint64_t degree = read_degree(v);
+      adj[v].resize(degree);
+      if (degree > 0) {
+        is.read(reinterpret_cast<char *>(adj[v].data()), degree * sizeof(edge_t));
+      }
+    }
+    result.emplace(num_nodes, num_edges, std::move(adj));
   }
 
   is.peek();
   ASSERT_MSG(is.eof() && !is.fail(), "read failed (invalid bgl file)");
 
-  return GraphType(num_nodes, num_edges, std::move(adj));
+  return result;
 }
 
+/// random access reader of graph file in binary format (version 2).
+/// edges from any node can be read with O(1) seeks without loading the whole file.
+/// each instance has its own file stream, so use one instance per thread
+template <typename GraphType>
+class binary_graph_reader {
+public:
+  using edge_type = typename GraphType::edge_type;
+
+  /// open |filename|.
+  /// when type does not match and |accept_mismatch|, |is_open()| returns false
+  binary_graph_reader(const path &filename, bool accept_mismatch = false)
+      : ifs_(filename.string(), std::ios_base::binary) {
+    ASSERT_MSG(ifs_, "file does not exist: {}", filename);
+    std::optional<binary_header> header = read_binary_header<GraphType>(ifs_, accept_mismatch);
+    if (!header.has_value()) return;
+    header_ = header.value();
+    ASSERT_MSG(header_.version >= 2, "random access requires version 2 file: {} (version {})",
+               filename, header_.version);
+    ASSERT_MSG(path::size(filename) == header_.edges_position() + num_edges() * sizeof(edge_type),
+               "read failed (invalid bgl file)");
+    is_open_ = true;
+  }
+
+  /// determine whether the file is opened successfully
+  bool is_open() const noexcept { return is_open_; }
+
+  /// return the number of nodes
+  node_t num_nodes() const noexcept { return header_.num_nodes; }
+
+  /// return the number of edges
+  std::size_t num_edges() const noexcept { return header_.num_edges; }
+
+  /// read offsets of nodes in [|first|, |last|] (note: closed interval)
+  std::vector<std::uint64_t> read_offsets(node_t first, node_t last) {
+    ASSERT_MSG(first <= last && last <= num_nodes(), "invalid node range: [{}, {}]", first, last);
+    std::vector<std::uint64_t> offsets(last - first + 1);
+    ifs_.seekg(header_.offsets_position() + 8 * std::uint64_t(first));
+    ifs_.read(reinterpret_cast<char *>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+    ASSERT_MSG(ifs_, "read failed (invalid bgl file)");
+    return offsets;
+  }
+
+  /// read [|first|, |last|)-th edges of edge array into |out|
+  void read_edges(std::uint64_t first, std::uint64_t last, edge_type *out) {
+    ASSERT_MSG(first <= last && last <= num_edges(), "invalid edge range: [{}, {})", first, last);
+    if (first == last) return;
+    ifs_.seekg(header_.edges_position() + first * sizeof(edge_type));
+    ifs_.read(reinterpret_cast<char *>(out), (last - first) * sizeof(edge_type));
+    ASSERT_MSG(ifs_, "read failed (invalid bgl file)");
+  }
+
+  /// read edge list from node |v|
+  std::vector<edge_type> edges(node_t v) {
+    std::vector<std::uint64_t> offsets = read_offsets(v, v + 1);
+    check_offsets(offsets);
+    std::vector<edge_type> es(offsets[1] - offsets[0]);
+    read_edges(offsets[0], offsets[1], es.data());
+    return es;
+  }
+
+  /// read edges from nodes in [|first|, |last|).
+  /// returned graph has all nodes of the file, but other nodes have no edges
+  GraphType read_range(node_t first, node_t last) {
+    std::vector<std::uint64_t> range_offsets = read_offsets(first, last);
+    check_offsets(range_offsets);
+    std::uint64_t base = range_offsets.front();
+    std::uint64_t num_range_edges = range_offsets.back() - base;
+
+    if constexpr (is_csr_graph_v<GraphType>) {
+      std::vector<std::uint64_t> offsets(num_nodes() + 1, 0);
+      for (node_t v : irange(first, last)) {
+        offsets[v + 1] = range_offsets[v - first + 1] - base;
+      }
+      std::fill(offsets.begin() + last + 1, offsets.end(), num_range_edges);
+      std::vector<edge_type> edges(num_range_edges);
+      read_edges(base, range_offsets.back(), edges.data());
+      return {std::move(offsets), std::move(edges)};
+    } else {
+      adjacency_list<edge_type> adj(num_nodes());
+      read_range_into(first, last, range_offsets, adj);
+      return {num_nodes(), num_range_edges, std::move(adj)};
+    }
+  }
+
+  /// read edges from nodes in [|first|, |last|) into |adj|
+  /// @param range_offsets offsets of nodes in [|first|, |last|]
+  void read_range_into(node_t first, node_t last, const std::vector<std::uint64_t> &range_offsets,
+                       adjacency_list<edge_type> &adj) {
+    ifs_.seekg(header_.edges_position() + range_offsets.front() * sizeof(edge_type));
+    for (node_t v : irange(first, last)) {
+      std::uint64_t degree = range_offsets[v - first + 1] - range_offsets[v - first];
+      adj[v].resize(degree);
+      if (degree > 0) {
+        ifs_.read(reinterpret_cast<char *>(adj[v].data()), degree * sizeof(edge_type));
+      }
+    }
+    ASSERT_MSG(ifs_, "read failed (invalid bgl file)");
+  }
+
+private:
+  std::ifstream ifs_;
+  binary_header header_;
+  bool is_open_ = false;
+
+  // differences of |offsets| are used as degrees, so they must not decrease or exceed edge array
+  void check_offsets(const std::vector<std::uint64_t> &offsets) const {
+    ASSERT_MSG(std::is_sorted(offsets.begin(), offsets.end()) && offsets.back() <= num_edges(),
+               "read failed (invalid bgl file)");
+  }
+};
+
 /// read graph from |filename| in binary format.
+/// version 2 files are read in parallel: each thread reads a node range of similar edge count.
 /// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
 template <typename GraphType>
 std::optional<GraphType> read_graph_binary_optional(const path &filename,
-                                                    bool accept_mismatch = false) {
+                                                    bool accept_mismatch = false,
+                                                    int num_threads = 0) {
   std::ifstream ifs(filename.string(), std::ios_base::binary);
   ASSERT_MSG(ifs, "file does not exist: {}", filename);
-  return read_graph_binary_optional<GraphType>(ifs, accept_mismatch);
+  std::optional<binary_header> header = read_binary_header<GraphType>(ifs, accept_mismatch);
+  if (!header.has_value()) {
+    return std::nullopt;
+  }
+  if (header->version == 1) {
+    ifs.seekg(0);
+    return read_graph_binary_optional<GraphType>(ifs, accept_mismatch);
+  }
+
+  using edge_t = typename GraphType::edge_type;
+  binary_graph_reader<GraphType> reader(filename);
+  const node_t n = reader.num_nodes();
+  std::vector<std::uint64_t> offsets = reader.read_offsets(0, n);
+  ASSERT_MSG(is_valid_offset_table(offsets.data(), n, reader.num_edges()),
+             "read failed (invalid bgl file)");
+
+  // split nodes into chunks of similar number of edges
+  const std::uint64_t kChunkBytes = 64 << 20;
+  std::size_t num_chunks = reader.num_edges() * sizeof(edge_t) / kChunkBytes + 1;
+  num_chunks = std::min<std::size_t>(num_chunks, std::max<node_t>(n, 1));
+  std::vector<node_t> bounds(num_chunks + 1, n);
+  bounds[0] = 0;
+  for (std::size_t i : irange<std::size_t>(1, num_chunks)) {
+    std::uint64_t target = reader.num_edges() / num_chunks * i;
+    bounds[i] = std::lower_bound(offsets.begin(), offsets.end(), target) - offsets.begin();
+    bounds[i] = std::max(bounds[i], bounds[i - 1]);
+  }
+
+  if (num_threads == 0) {
+    num_threads = default_num_threads(num_chunks, 1);
+  }
+  std::vector<std::optional<binary_graph_reader<GraphType>>> readers(num_threads);
+
+  std::optional<GraphType> result;
+  if constexpr (is_csr_graph_v<GraphType>) {
+    std::vector<edge_t> edges(reader.num_edges());
+    parallel_for(
+        num_chunks, 1,
+        fn(c, t) {
+          if (!readers[t].has_value()) readers[t].emplace(filename);
+          readers[t]->read_edges(offsets[bounds[c]], offsets[bounds[c + 1]],
+                                 edges.data() + offsets[bounds[c]]);
+        },
+        num_threads);
+    result.emplace(std::move(offsets), std::move(edges));
+  } else {
+    adjacency_list<edge_t> adj(n);
+    parallel_for(
+        num_chunks, 1,
+        fn(c, t) {
+          if (!readers[t].has_value()) readers[t].emplace(filename);
+          std::vector<std::uint64_t> range_offsets(offsets.begin() + bounds[c],
+                                                   offsets.begin() + bounds[c + 1] + 1);
+          readers[t]->read_range_into(bounds[c], bounds[c + 1], range_offsets, adj);
+        },
+        num_threads);
+    result.emplace(n, reader.num_edges(), std::move(adj));
+  }
+
+  return result;
 }
 
 /// read graph from |is| in binary format
@@ -224,61 +672,175 @@ GraphType read_graph_binary(const path &filename) {
   return read_graph_binary_optional<GraphType>(filename).value();
 }
 
-/// write graph to |os| in binary format
+/// read edges from nodes in [|first|, |last|) of |filename| in binary format (version 2).
+/// returned graph has all nodes of the file, but other nodes have no edges
 template <typename GraphType>
-void write_graph_binary(std::ostream &os, const GraphType &g) {
+GraphType read_graph_binary_range(const path &filename, node_t first, node_t last) {
+  return binary_graph_reader<GraphType>(filename).read_range(first, last);
+}
+
+/// return CSR graph on graph data [|data|, |data| + |size|) in binary format.
+/// for version 2 data, edges are served directly from the memory region (zero-copy).
+/// version 1 data interleave degrees with edges, so they are decoded into memory instead.
+/// |storage| is an owner object that keeps the memory region alive during the lifetime of graph.
+/// when type does not match and |accept_mismatch|, return |nullopt|
+template <typename GraphType>
+std::optional<GraphType> view_graph_binary_optional(const char *data, std::size_t size,
+                                                    std::shared_ptr<const void> storage,
+                                                    bool accept_mismatch = false) {
+  using edge_t = typename GraphType::edge_type;
+  using offset_t = typename GraphType::offset_type;
+  static_assert(is_csr_graph_v<GraphType>, "graph type must be CSR graph");
+
+  memory_streambuf buf(data, size);
+  std::istream is(&buf);
+  std::optional<binary_header> header = read_binary_header<GraphType>(is, accept_mismatch);
+  if (!header.has_value()) {
+    return std::nullopt;
+  }
+
+  if (header->version == 1) {
+    memory_streambuf buf_v1(data, size);
+    std::istream is_v1(&buf_v1);
+    return read_graph_binary_optional<GraphType>(is_v1, accept_mismatch);
+  }
+
+  ASSERT_MSG(size == header->edges_position() + header->num_edges * sizeof(edge_t),
+             "read failed (invalid bgl file)");
+  auto offsets = reinterpret_cast<const offset_t *>(data + header->offsets_position());
+  auto edges = reinterpret_cast<const edge_t *>(data + header->edges_position());
+  // the mapped offsets are checked once, so that |edges(v)| never reads out of the file
+  ASSERT_MSG(is_valid_offset_table(offsets, header->num_nodes, header->num_edges),
+             "read failed (invalid bgl file)");
+
+  return GraphType(header->num_nodes, offsets, edges, std::move(storage));
+}
+
+/// memory-map graph file |filename| in binary format and return CSR graph on the mapping.
+/// for version 2 files, edges are served directly from the mapped pages (zero-copy): startup time
+/// does not depend on graph size and page cache is shared among processes using the same file.
+/// version 1 files interleave degrees with edges, so they are decoded into memory instead.
+/// when type does not match and |accept_mismatch|, return |nullopt|
+template <typename GraphType>
+std::optional<GraphType> map_graph_binary_optional(const path &filename,
+                                                   bool accept_mismatch = false) {
+  auto file = std::make_shared<mapped_file>(filename);
+  const char *data = file->data();
+  std::size_t size = file->size();
+  return view_graph_binary_optional<GraphType>(data, size, std::move(file), accept_mismatch);
+}
+
+/// memory-map graph file |filename| in binary format and return CSR graph on the mapping
+template <typename GraphType>
+GraphType map_graph_binary(const path &filename) {
+  return map_graph_binary_optional<GraphType>(filename).value();
+}
+
+/// write graph to |os| in binary format (version 1 or 2)
+template <typename GraphType>
+void write_graph_binary(std::ostream &os, const GraphType &g, int version = 2) {
   using edge_t = typename GraphType::edge_type;
   using weight_t = decltype(weight(edge_t{}));
   static_assert(std::is_arithmetic_v<weight_t>, "edge weight must be arithmetic type");
   ASSERT_MSG(os, "empty stream");
+  ASSERT_MSG(version == 1 || version == 2, "unsupported version: {}", version);
 
   // header
   os.write("bgl", 4);
+  if (version == 2) {
+    write_binary(os, kBinaryVersionFlag | static_cast<std::uint32_t>(version));
+  }
   write_binary(os, static_cast<std::uint32_t>(g.weight_sizeof()));
   write_binary(os, static_cast<std::uint32_t>(std::is_integral_v<weight_t>));
-
-  // graph body
   write_binary(os, g.num_nodes());
+  if (version == 2) {
+    write_binary(os, static_cast<std::uint32_t>(sizeof(edge_t)));
+  }
   write_binary(os, static_cast<std::uint64_t>(g.num_edges()));
-  for (node_t v : g.nodes()) {
-    write_binary(os, static_cast<std::uint64_t>(g.outdegree(v)));
-    if (g.outdegree(v) > 0) {
-      os.write(reinterpret_cast<const char *>(g.edges(v).data()), g.outdegree(v) * sizeof(edge_t));
+
+  // graph body
+  if (version == 1) {
+    for (node_t v : g.nodes()) {
+      write_binary(os, static_cast<std::uint64_t>(g.outdegree(v)));
+      if (g.outdegree(v) > 0) {
+        os.write(reinterpret_cast<const char *>(g.edges(v).data()),
+                 g.outdegree(v) * sizeof(edge_t));
+      }
+    }
+  } else {
+    binary_header header;
+    header.num_nodes = g.num_nodes();
+    std::uint64_t offset = 0;
+    write_binary(os, offset);
+    for (node_t v : g.nodes()) {
+      offset += g.outdegree(v);
+      write_binary(os, offset);
+    }
+    std::uint64_t offsets_end = header.offsets_position() + 8 * (std::uint64_t(g.num_nodes()) + 1);
+    for (std::uint64_t i [[maybe_unused]] : irange(offsets_end, header.edges_position())) {
+      os.put('\0');
+    }
+    for (node_t v : g.nodes()) {
+      if (g.outdegree(v) > 0) {
+        os.write(reinterpret_cast<const char *>(g.edges(v).data()),
+                 g.outdegree(v) * sizeof(edge_t));
+      }
     }
   }
 
   os.flush();
 }
 
-/// write graph to |filename| in binary format
+/// write graph to |filename| in binary format (version 1 or 2)
 template <typename GraphType>
-void write_graph_binary(const path &filename, const GraphType &g) {
+void write_graph_binary(const path &filename, const GraphType &g, int version = 2) {
   std::ofstream ofs(filename.string(), std::ios_base::binary);
   ASSERT_MSG(ofs, "file cannot open: {}", filename);
-  write_graph_binary(ofs, g);
+  write_graph_binary(ofs, g, version);
 }
 
 
-/* compressed input */
+/* compressed I/O */
 
-/// read compressed tsv graph from |is|
+/// read compressed tsv graph from |is|.
+/// input is decompressed on the fly and parsed by batches (see |read_graph_tsv_optional|),
+/// so neither the compressed nor the decompressed content is held in memory as a whole.
 /// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
 template <typename GraphType>
 std::optional<GraphType> read_graph_tsv_zstd_optional(std::istream &is,
-                                                      bool accept_mismatch = false) {
+                                                      bool accept_mismatch = false,
+                                                      int num_threads = 0) {
+  ASSERT_MSG(is, "empty stream");
   zstd_decode_filter_buf buf(is.rdbuf());
   std::istream is_decoded(&buf);
-  return read_graph_tsv_optional<GraphType>(is_decoded, accept_mismatch);
+  return read_graph_tsv_optional<GraphType>(is_decoded, accept_mismatch, num_threads);
 }
 
-/// read comressed tsv graph from |filename|
+/// read comressed tsv graph from |filename| (file is memory-mapped).
+/// a file of multiple zstd frames (e.g., written by |write_graph_tsv_zstd| or `pzstd`) is
+/// decompressed in parallel, so the whole decompressed content is held in memory until parsed.
+/// a single-frame file (e.g., written by `zstd`, even with `-T0`) is decompressed on the fly
+/// as in the overload for |std::istream|.
 /// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
 template <typename GraphType>
-std::optional<GraphType> read_graph_tsv_zstd_optional(const path &file,
-                                                      bool accept_mismatch = false) {
-  std::ifstream ifs(file.string(), std::ios_base::binary);
-  ASSERT_MSG(ifs, "file does not exist: {}", file);
-  return read_graph_tsv_zstd_optional<GraphType>(ifs, accept_mismatch);
+std::optional<GraphType> read_graph_tsv_zstd_optional(const path &filename,
+                                                      bool accept_mismatch = false,
+                                                      int num_threads = 0) {
+  std::vector<char> buf;
+  {
+    mapped_file mf(filename);
+    mf.advise_sequential();
+    if (zstd_frames(mf.data(), mf.size()).size() <= 1) {
+      memory_streambuf mbuf(mf.data(), mf.size());
+      std::istream is(&mbuf);
+      return read_graph_tsv_zstd_optional<GraphType>(is, accept_mismatch, num_threads);
+    }
+    buf = zstd_decompress(mf.data(), mf.size(), num_threads);
+  }
+  return parse_graph_tsv_optional<GraphType>(buf.data(), buf.size(), accept_mismatch,
+                                             num_threads);
 }
 
 /// read compressed tsv graph from |is|
@@ -293,24 +855,58 @@ GraphType read_graph_tsv_zstd(const path &filename) {
   return read_graph_tsv_zstd_optional<GraphType>(filename).value();
 }
 
-/// read compressed binary graph from |is|
+/// read graph from decompressed binary data |buf|.
+/// CSR graph is built directly on |buf| (version 2) without copying edges
+template <typename GraphType>
+std::optional<GraphType> read_graph_binary_buffer_optional(std::vector<char> &&buf,
+                                                           bool accept_mismatch) {
+  if constexpr (is_csr_graph_v<GraphType>) {
+    auto storage = std::make_shared<std::vector<char>>(std::move(buf));
+    const char *data = storage->data();
+    std::size_t size = storage->size();
+    return view_graph_binary_optional<GraphType>(data, size, std::move(storage), accept_mismatch);
+  } else {
+    memory_streambuf mbuf(buf.data(), buf.size());
+    std::istream is(&mbuf);
+    return read_graph_binary_optional<GraphType>(is, accept_mismatch);
+  }
+}
+
+/// read compressed binary graph from |is|.
+/// input is decompressed on the fly, so the compressed content is not held in memory.
 /// when type does not match and |accept_mismatch|, return |nullopt|
 template <typename GraphType>
 std::optional<GraphType> read_graph_binary_zstd_optional(std::istream &is,
                                                          bool accept_mismatch = false) {
+  ASSERT_MSG(is, "empty stream");
   zstd_decode_filter_buf buf(is.rdbuf());
   std::istream is_decoded(&buf);
   return read_graph_binary_optional<GraphType>(is_decoded, accept_mismatch);
 }
 
-/// read compressed binary graph from |filename|
+/// read compressed binary graph from |filename| (file is memory-mapped).
+/// a file of multiple zstd frames (e.g., written by |write_graph_binary_zstd| or `pzstd`) is
+/// decompressed in parallel into a buffer, on which CSR graph is built without copying edges.
+/// a single-frame file (e.g., written by `zstd`, even with `-T0`) is decompressed on the fly
+/// as in the overload for |std::istream|.
 /// when type does not match and |accept_mismatch|, return |nullopt|
+/// @param num_threads the number of threads: when specified 0, set automatically
 template <typename GraphType>
 std::optional<GraphType> read_graph_binary_zstd_optional(const path &filename,
-                                                         bool accept_mismatch = false) {
-  std::ifstream ifs(filename.string(), std::ios_base::binary);
-  ASSERT_MSG(ifs, "file does not exist: {}", filename);
-  return read_graph_binary_zstd_optional<GraphType>(ifs, accept_mismatch);
+                                                         bool accept_mismatch = false,
+                                                         int num_threads = 0) {
+  std::vector<char> buf;
+  {
+    mapped_file mf(filename);
+    mf.advise_sequential();
+    if (zstd_frames(mf.data(), mf.size()).size() <= 1) {
+      memory_streambuf mbuf(mf.data(), mf.size());
+      std::istream is(&mbuf);
+      return read_graph_binary_zstd_optional<GraphType>(is, accept_mismatch);
+    }
+    buf = zstd_decompress(mf.data(), mf.size(), num_threads);
+  }
+  return read_graph_binary_buffer_optional<GraphType>(std::move(buf), accept_mismatch);
 }
 
 /// read compressed binary graph from |is|
@@ -325,6 +921,58 @@ GraphType read_graph_binary_zstd(const path &filename) {
   return read_graph_binary_zstd_optional<GraphType>(filename).value();
 }
 
+/// write graph to |os| as compressed tsv file.
+/// output is compressed on the fly into independent zstd frames in parallel,
+/// so that it can also be decompressed in parallel
+/// @param level compression level
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @param write_info whether to write the header as |write_graph_tsv|
+template <typename GraphType>
+void write_graph_tsv_zstd(std::ostream &os, const GraphType &g, int level = 3,
+                          int num_threads = 0, bool write_info = true) {
+  ASSERT_MSG(os, "empty stream");
+  zstd_encode_filter_buf buf(os.rdbuf(), level, num_threads);
+  std::ostream os_encoded(&buf);
+  write_graph_tsv(os_encoded, g, write_info);
+}
+
+/// write graph to |filename| as compressed tsv file
+/// @param level compression level
+/// @param num_threads the number of threads: when specified 0, set automatically
+/// @param write_info whether to write the header as |write_graph_tsv|
+template <typename GraphType>
+void write_graph_tsv_zstd(const path &filename, const GraphType &g, int level = 3,
+                          int num_threads = 0, bool write_info = true) {
+  std::ofstream ofs(filename.string(), std::ios_base::binary);
+  ASSERT_MSG(ofs, "file cannot open: {}", filename);
+  write_graph_tsv_zstd(ofs, g, level, num_threads, write_info);
+}
+
+/// write graph to |os| as compressed binary file (version 2).
+/// output is compressed on the fly into independent zstd frames in parallel,
+/// so that it can also be decompressed in parallel
+/// @param level compression level
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+void write_graph_binary_zstd(std::ostream &os, const GraphType &g, int level = 3,
+                             int num_threads = 0) {
+  ASSERT_MSG(os, "empty stream");
+  zstd_encode_filter_buf buf(os.rdbuf(), level, num_threads);
+  std::ostream os_encoded(&buf);
+  write_graph_binary(os_encoded, g);
+}
+
+/// write graph to |filename| as compressed binary file (version 2)
+/// @param level compression level
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename GraphType>
+void write_graph_binary_zstd(const path &filename, const GraphType &g, int level = 3,
+                             int num_threads = 0) {
+  std::ofstream ofs(filename.string(), std::ios_base::binary);
+  ASSERT_MSG(ofs, "file cannot open: {}", filename);
+  write_graph_binary_zstd(ofs, g, level, num_threads);
+}
+
 /// read graph in automatically determined format
 /// when type does not match and |accept_mismatch|, return |nullopt|
 template <typename GraphType>
@@ -338,6 +986,9 @@ std::optional<GraphType> read_graph_optional(const path &filename, bool accept_m
       return read_graph_tsv_zstd_optional<GraphType>(filename, accept_mismatch);
     }
   } else if (ext == ".bgl") {
+    if constexpr (is_csr_graph_v<GraphType>) {
+      return map_graph_binary_optional<GraphType>(filename, accept_mismatch);
+    }
     return read_graph_binary_optional<GraphType>(filename, accept_mismatch);
   } else {
     return read_graph_tsv_optional<GraphType>(filename, accept_mismatch);
@@ -350,6 +1001,27 @@ GraphType read_graph(const path &filename) {
   return read_graph_optional<GraphType>(filename).value();
 }
 
+/// write graph in format determined by extension of |filename|:
+/// .bgl (binary), .bgl.zst (compressed binary), .tsv.zst (compressed tsv), otherwise tsv
+/// @param level compression level (used only for .zst)
+/// @param num_threads the number of threads for compression: when specified 0, set automatically
+template <typename GraphType>
+void write_graph(const path &filename, const GraphType &g, int level = 3, int num_threads = 0) {
+  std::string ext = filename.extension();
+  if (ext == ".zst") {
+    std::string second_ext = filename.clone().replace_extension().extension();
+    if (second_ext == ".bgl") {
+      write_graph_binary_zstd(filename, g, level, num_threads);
+    } else {
+      write_graph_tsv_zstd(filename, g, level, num_threads);
+    }
+  } else if (ext == ".bgl") {
+    write_graph_binary(filename, g);
+  } else {
+    write_graph_tsv(filename, g);
+  }
+}
+
 
 /* traverse directory */
 
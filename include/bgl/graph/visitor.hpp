@@ -1,8 +1,9 @@
 #pragma once
 #include "basic_graph.hpp"
 #include "../extlib/radix_heap.hpp"
-#include <functional>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace bgl {
 /// radix heap specialized for Dijkstra's algorithm
@@ -32,7 +33,7 @@ public:
     for (auto v : vs_) ws_[v] = std::numeric_limits<weight_type>::max();
     vs_.clear();
     while (!h_.empty()) {
-      ws_[top_vertex()] = std::numeric_limits<weight_type>::max();
+      ws_[h_.top_value()] = std::numeric_limits<weight_type>::max();
       h_.pop();
     }
     h_.clear();
@@ -67,7 +68,7 @@ private:
 };
 
 // general visitor
-template <typename GraphType>
+template <typename GraphType, typename = void>
 class visitor_by_distance {
 public:
   using graph_type = GraphType;
@@ -75,7 +76,8 @@ public:
 
   visitor_by_distance(const graph_type &g) : g_{g}, h_(g) {}
 
-  void visit(node_t source, std::function<bool(node_t, weight_type)> pred) {
+  template <typename Predicate>
+  void visit(node_t source, Predicate &&pred) {
     h_.decrease(source, 0);
 
     while (!h_.empty()) {
@@ -99,16 +101,18 @@ private:
 };
 
 // visitor specialized for unweighted graphs
-template <>
-class visitor_by_distance<graph> {
+template <typename GraphType>
+class visitor_by_distance<
+    GraphType, std::enable_if_t<std::is_same_v<typename GraphType::edge_type, unweighted_edge_t>>> {
 public:
-  using graph_type = graph;
-  using weight_type = graph_type::weight_type;
+  using graph_type = GraphType;
+  using weight_type = typename graph_type::weight_type;
 
   visitor_by_distance(const graph_type &g)
       : g_{g}, queue_(g.num_nodes()), visited_(g.num_nodes(), false) {}
 
-  void visit(node_t source, std::function<bool(node_t, weight_type)> pred) {
+  template <typename Predicate>
+  void visit(node_t source, Predicate &&pred) {
     std::size_t head = 0, tail = 0, boundary = 1;
     weight_type w = 0;
     queue_[tail++] = source;
@@ -148,10 +152,9 @@ private:
 /// @param g input graph
 /// @param source first visited node
 /// @param pred predicate function: bool(node_t, weight_type)
-template <typename GraphType>
-void visit_by_distance(const GraphType &g, node_t source,
-                       std::function<bool(node_t, typename GraphType::weight_type)> pred) {
-  visitor_by_distance<GraphType>(g).visit(source, pred);
+template <typename GraphType, typename Predicate>
+void visit_by_distance(const GraphType &g, node_t source, Predicate &&pred) {
+  visitor_by_distance<GraphType>(g).visit(source, std::forward<Predicate>(pred));
 }
 
 /// compute single-source shortest-path distances
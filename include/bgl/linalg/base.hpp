@@ -1,11 +1,13 @@
 #pragma once
 #include "bgl/data_structure/aligned_array.hpp"
 #include "bgl/graph/basic_graph.hpp"
+#include "bgl/graph/csr_graph.hpp"
 #include "bgl/util/all.hpp"
 
 #include <algorithm>
 #include <cstring>
 #include <random>
+#include <type_traits>
 
 /* write simple code - optimization is task for compilers */
 
@@ -158,7 +160,13 @@ inline real_vector generate_random_unit_vector(std::size_t n) {
 /// define sparse matrix type as weighted graph: A_ij = weight of edge from |i| to |j|
 using sparse_matrix = wgraph<double>;
 
-inline real_vector operator*(const sparse_matrix &A, const real_vector &x) {
+/// immutable sparse matrix type in CSR format
+using csr_sparse_matrix = csr_wgraph<double>;
+
+/// sparse matrix-vector multiplication: |MatrixType| is either sparse_matrix or csr_sparse_matrix
+template <typename MatrixType, typename = std::enable_if_t<std::is_same_v<
+                                   typename MatrixType::edge_type, weighted_edge_t<double>>>>
+real_vector operator*(const MatrixType &A, const real_vector &x) {
   real_vector y(x.size());
 
 #ifdef SINGLE_THREADED_MATRIX_VECTOR_MULTIPLICATION
@@ -6,10 +6,14 @@
 #include <vector>
 
 namespace bgl {
+/// solve Ax = b by GMRES(|restart|) with at most |max_iter| restarts (fewer when the total
+/// number of iterations would greatly exceed the dimension).
+/// when |num_iterations| is not null, the total number of inner iterations is stored there
 inline real_vector gmres(const sparse_matrix &A, const real_vector &b,
                          const std::pair<sparse_matrix, sparse_matrix> &precond_lu = {},
                          const real_vector &initial_guess = {},
-                         double tol = 1e-8, int restart = 30, int max_iter = 100) {
+                         double tol = 1e-8, int restart = 30, int max_iter = 100,
+                         int *num_iterations = nullptr) {
   std::size_t n = b.size();
   bool use_precond = !precond_lu.first.empty();
 
@@ -21,6 +25,7 @@ inline real_vector gmres(const sparse_matrix &A, const real_vector &b,
   restart = std::min(static_cast<std::size_t>(restart), n);
   max_iter = std::min(static_cast<std::size_t>(max_iter), n / restart + 1);
 
+  int total_iter = 0;
   real_vector x(n);
   if (initial_guess.size() == n) {
     x = initial_guess;
@@ -39,6 +44,7 @@ inline real_vector gmres(const sparse_matrix &A, const real_vector &b,
 
     for (int j : irange(restart)) {
       ++inner_iter;
+      ++total_iter;
 
       // Arnoldi
       q[j + 1] = A * q[j];
@@ -95,6 +101,7 @@ inline real_vector gmres(const sparse_matrix &A, const real_vector &b,
       CONSOLE_LOG("GMRES({}) converged\n  outer_iter = {}, inner_iter = {}\n  residual = {}",
                   restart, outer_iter + 1, inner_iter, residual.norm() / lub_norm);
 #endif
+      if (num_iterations != nullptr) *num_iterations = total_iter;
       return x;
     }
   }
@@ -106,6 +113,7 @@ inline real_vector gmres(const sparse_matrix &A, const real_vector &b,
               residual.norm() / lub_norm);
 #endif
 
+  if (num_iterations != nullptr) *num_iterations = total_iter;
   return x;
 }
 }  // namespace bgl
@@ -4,6 +4,7 @@
 #include "../extlib/rang.hpp"
 
 #include "assertion.hpp"
+#include "atomic.hpp"
 #include "container_manipulation.hpp"
 #include "demangle_typeid.hpp"
 #include "file.hpp"
@@ -12,5 +13,8 @@
 #include "irange.hpp"
 #include "lambda.hpp"
 #include "logging.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
 #include "random.hpp"
+#include "thread_pool.hpp"
 #include "zstd.hpp"
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+
+namespace bgl {
+/// atomically replace |a| with min(|a|, |value|): return true if |a| was updated
+template <typename T>
+bool atomic_fetch_min(std::atomic<T> &a, T value,
+                      std::memory_order order = std::memory_order_relaxed) {
+  T current = a.load(std::memory_order_relaxed);
+  while (value < current) {
+    if (a.compare_exchange_weak(current, value, order, std::memory_order_relaxed)) return true;
+  }
+  return false;
+}
+
+/// atomically replace |a| with max(|a|, |value|): return true if |a| was updated
+template <typename T>
+bool atomic_fetch_max(std::atomic<T> &a, T value,
+                      std::memory_order order = std::memory_order_relaxed) {
+  T current = a.load(std::memory_order_relaxed);
+  while (current < value) {
+    if (a.compare_exchange_weak(current, value, order, std::memory_order_relaxed)) return true;
+  }
+  return false;
+}
+
+/// atomically add |value| to |a| (also works for floating-point types before C++20):
+/// return the previous value
+template <typename T>
+T atomic_add(std::atomic<T> &a, T value, std::memory_order order = std::memory_order_relaxed) {
+  T current = a.load(std::memory_order_relaxed);
+  while (!a.compare_exchange_weak(current, current + value, order, std::memory_order_relaxed)) {
+    continue;
+  }
+  return current;
+}
+}  // namespace bgl
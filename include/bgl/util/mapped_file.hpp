@@ -0,0 +1,132 @@
+#pragma once
+#include "assertion.hpp"
+#include "file.hpp"
+#include "lambda.hpp"
+#include <cstddef>
+#include <fstream>
+#include <streambuf>
+#include <utility>
+#include <vector>
+
+#if defined(WIN32) || defined(_WIN32) || defined(_WIN64)
+#  define _BGL_NO_MMAP
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace bgl {
+/// read-only memory-mapped file.
+/// pages are loaded lazily and shared with other processes mapping the same file.
+/// (on platforms without mmap, the whole file is read into memory instead)
+class mapped_file {
+public:
+  mapped_file() {}
+
+  /// map |file| into memory
+  mapped_file(const path &file) {
+#ifdef _BGL_NO_MMAP
+    std::ifstream ifs(file.string(), std::ios_base::binary);
+    ASSERT_MSG(ifs, "file does not exist: {}", file);
+    buf_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    data_ = buf_.data();
+    size_ = buf_.size();
+#else
+    int fd = ::open(file.string().c_str(), O_RDONLY);
+    ASSERT_MSG(fd >= 0, "file does not exist: {}", file);
+    struct stat st;
+    ASSERT_MSG(::fstat(fd, &st) == 0, "fstat failed: {}", file);
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void *p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      ASSERT_MSG(p != MAP_FAILED, "mmap failed: {}", file);
+      data_ = static_cast<const char *>(p);
+    }
+    ::close(fd);
+#endif
+  }
+
+  // prohibit copying
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  mapped_file(mapped_file &&rhs) noexcept { *this = std::move(rhs); }
+
+  mapped_file &operator=(mapped_file &&rhs) noexcept {
+    if (this == &rhs) return *this;
+    unmap();
+    data_ = std::exchange(rhs.data_, nullptr);
+    size_ = std::exchange(rhs.size_, 0);
+#ifdef _BGL_NO_MMAP
+    buf_ = std::move(rhs.buf_);
+#endif
+    return *this;
+  }
+
+  ~mapped_file() { unmap(); }
+
+  /// return pointer to the beginning of mapped region
+  const char *data() const noexcept { return data_; }
+
+  /// return size of mapped region [byte]
+  std::size_t size() const noexcept { return size_; }
+
+  /// hint that the region [|offset|, |offset| + |length|) will be accessed sequentially
+  void advise_sequential(std::size_t offset = 0, std::size_t length = 0) const {
+    advise(offset, length, fn(p, len) {
+#ifndef _BGL_NO_MMAP
+      ::madvise(p, len, MADV_SEQUENTIAL);
+#endif
+    });
+  }
+
+  /// hint that the region [|offset|, |offset| + |length|) will be accessed randomly
+  void advise_random(std::size_t offset = 0, std::size_t length = 0) const {
+    advise(offset, length, fn(p, len) {
+#ifndef _BGL_NO_MMAP
+      ::madvise(p, len, MADV_RANDOM);
+#endif
+    });
+  }
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+#ifdef _BGL_NO_MMAP
+  std::vector<char> buf_;
+#endif
+
+  void unmap() {
+#ifndef _BGL_NO_MMAP
+    if (data_ != nullptr) ::munmap(const_cast<char *>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  template <typename Func>
+  void advise(std::size_t offset, std::size_t length, Func f) const {
+    if (data_ == nullptr || offset >= size_) return;
+    if (length == 0 || offset + length > size_) length = size_ - offset;
+#ifndef _BGL_NO_MMAP
+    // madvise() requires page-aligned address
+    std::size_t page_size = ::sysconf(_SC_PAGESIZE);
+    std::size_t aligned = offset / page_size * page_size;
+    f(const_cast<char *>(data_) + aligned, length + (offset - aligned));
+#else
+    f(data_ + offset, length);
+#endif
+  }
+};
+
+/// read-only streambuf over memory region (e.g., memory-mapped file)
+class memory_streambuf : public std::streambuf {
+public:
+  memory_streambuf(const char *data, std::size_t size) {
+    char *p = const_cast<char *>(data);
+    setg(p, p, p + size);
+  }
+};
+}  // namespace bgl
@@ -0,0 +1,101 @@
+#pragma once
+#include "irange.hpp"
+#include "lambda.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace bgl {
+/// return the number of threads for processing |n| elements in chunks of |unit| elements
+/// (at most the size of the shared thread pool)
+inline int default_num_threads(std::size_t n, std::size_t unit) {
+  return std::min<std::size_t>(thread_pool::shared().size(), (n + unit - 1) / unit);
+}
+
+/// parallel for-loop over [0, |n|) with work stealing, where index |i| costs |weight(i)|.
+/// each thread first owns a contiguous range of indices and processes chunks from its front;
+/// a chunk ends when accumulated weight reaches |unit|, so that a chunk containing a heavy
+/// index (e.g., a hub node) is short. threads that run out of work steal the latter half of
+/// the remaining range of another thread. threads are taken from |thread_pool::shared()|.
+/// @param n the number of indices
+/// @param unit total weight of a chunk
+/// @param weight weight function (must be thread safe): std::size_t(std::size_t)
+/// @param callback callback function (must be thread safe): arguments are index and thread ID
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename WeightFunction, typename Callback>
+void parallel_for_weighted(std::size_t n, std::size_t unit, const WeightFunction &weight,
+                           const Callback &callback, int num_threads = 0) {
+  if (num_threads == 0) {
+    num_threads = default_num_threads(n, unit);
+  }
+  if (n == 0 || num_threads == 0) return;
+
+  struct alignas(64) range {
+    std::mutex mutex;
+    std::size_t first;
+    std::size_t last;
+  };
+
+  std::vector<range> ranges(num_threads);
+  for (int t : irange(num_threads)) {
+    ranges[t].first = n * t / num_threads;
+    ranges[t].last = n * (t + 1) / num_threads;
+  }
+
+  // take a chunk from the front of own range
+  auto claim = [&](range &r, std::size_t &first, std::size_t &last) {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (r.first >= r.last) return false;
+    first = last = r.first;
+    for (std::size_t w = 0; last < r.last && w < unit; ++last) {
+      w += weight(last);
+    }
+    r.first = last;
+    return true;
+  };
+
+  // steal the latter half of the remaining range of another thread
+  auto steal = [&](int t) {
+    for (int j : irange(1, num_threads)) {
+      range &victim = ranges[(t + j) % num_threads];
+      std::size_t first, last;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.first >= victim.last) continue;
+        first = victim.first + (victim.last - victim.first) / 2;
+        last = victim.last;
+        victim.last = first;
+      }
+      std::lock_guard<std::mutex> lock(ranges[t].mutex);
+      ranges[t].first = first;
+      ranges[t].last = last;
+      return true;
+    }
+    return false;
+  };
+
+  thread_pool::shared().run(num_threads, [&](int t) {
+    std::size_t first, last;
+    do {
+      while (claim(ranges[t], first, last)) {
+        for (std::size_t i : irange(first, last)) {
+          callback(i, t);
+        }
+      }
+    } while (steal(t));
+  });
+}
+
+/// parallel for-loop over [0, |n|): chunks of |unit| indices are dispatched with work stealing
+/// @param n the number of indices
+/// @param unit chunk size
+/// @param callback callback function (must be thread safe): arguments are index and thread ID
+/// @param num_threads the number of threads: when specified 0, set automatically
+template <typename Callback>
+void parallel_for(std::size_t n, std::size_t unit, const Callback &callback, int num_threads = 0) {
+  parallel_for_weighted(n, unit, [](std::size_t) -> std::size_t { return 1; }, callback,
+                        num_threads);
+}
+}  // namespace bgl
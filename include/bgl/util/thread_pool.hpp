@@ -0,0 +1,155 @@
+#pragma once
+#include "irange.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bgl {
+/// persistent thread pool: worker threads are created once and reused by parallel loops.
+/// a job runs on the caller thread (thread ID 0) and the workers (thread ID 1, 2, ...).
+/// only one job runs at a time; when the pool is busy (e.g., nested parallel loops),
+/// |run| falls back to spawning temporary threads
+class thread_pool {
+public:
+  /// @param num_threads the number of threads including the caller thread:
+  ///                    when specified 0, set to the number of hardware threads
+  thread_pool(int num_threads = 0) { resize(num_threads); }
+
+  // prohibit copying
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  ~thread_pool() { stop_workers(); }
+
+  /// return the number of threads including the caller thread
+  int size() const noexcept { return size_; }
+
+  /// change the number of threads including the caller thread
+  /// (when specified 0, set to the number of hardware threads)
+  void resize(int num_threads) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    if (num_threads <= 0) {
+      num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+    }
+    stop_workers();
+    size_ = num_threads;
+  }
+
+  /// run |task(thread_id)| on |num_threads| threads and wait for all of them
+  void run(int num_threads, const std::function<void(int)> &task) {
+    if (num_threads <= 1) {
+      if (num_threads == 1) task(0);
+      return;
+    }
+
+    // a nested loop must not touch |run_mutex_|, which its own thread may already hold
+    if (in_pool()) {
+      run_on_temporary_threads(num_threads, task);
+      return;
+    }
+    std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+    if (!run_lock.owns_lock()) {
+      run_on_temporary_threads(num_threads, task);
+      return;
+    }
+
+    while (static_cast<int>(workers_.size()) < num_threads - 1) {
+      int id = workers_.size() + 1;
+      workers_.emplace_back([this, id] { worker_loop(id); });
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      num_participants_ = num_threads;
+      remaining_ = num_threads - 1;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+
+    // even if |task| throws, reset the flag and wait for the workers, which still refer to |task|
+    struct job_guard {
+      thread_pool &pool;
+      job_guard(thread_pool &pool) : pool{pool} { in_pool() = true; }
+      ~job_guard() {
+        in_pool() = false;
+        std::unique_lock<std::mutex> lock(pool.mutex_);
+        pool.done_cv_.wait(lock, [&] { return pool.remaining_ == 0; });
+        pool.task_ = nullptr;
+      }
+    } guard(*this);
+    task(0);
+  }
+
+  /// return the thread pool shared by parallel loops of the library
+  static thread_pool &shared() {
+    // never destroyed: workers may still be blocked when the program exits
+    static thread_pool *pool = new thread_pool();
+    return *pool;
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  int size_ = 1;
+
+  std::mutex run_mutex_;  // held while a job is running
+  std::mutex mutex_;      // protects the following members
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(int)> *task_ = nullptr;
+  int num_participants_ = 0;
+  int remaining_ = 0;
+  std::size_t generation_ = 0;
+  bool stopping_ = false;
+
+  static bool &in_pool() {
+    thread_local bool flag = false;
+    return flag;
+  }
+
+  static void run_on_temporary_threads(int num_threads, const std::function<void(int)> &task) {
+    std::vector<std::thread> threads;
+    for (int i : irange(1, num_threads)) {
+      threads.emplace_back(task, i);
+    }
+    task(0);
+    for (auto &t : threads) t.join();
+  }
+
+  void worker_loop(int id) {
+    in_pool() = true;
+    std::size_t seen = 0;
+    while (true) {
+      const std::function<void(int)> *task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+        if (stopping_) return;
+        seen = generation_;
+        if (id >= num_participants_) continue;
+        task = task_;
+      }
+
+      (*task)(id);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--remaining_ == 0) done_cv_.notify_one();
+    }
+  }
+
+  void stop_workers() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &t : workers_) t.join();
+    workers_.clear();
+    stopping_ = false;
+  }
+};
+}  // namespace bgl
@@ -1,7 +1,17 @@
 #pragma once
 #include "../extlib/zstd/zstd.h"
+#include "assertion.hpp"
+#include "lambda.hpp"
+#include "parallel.hpp"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace bgl {
 class zstd_decode_filter_buf : public std::streambuf {
@@ -36,9 +46,12 @@ protected:
     while (gptr() == egptr()) {
       if (input_.pos == input_.size) {
         if (to_read_ == 0) {
-          // ensure EOF
-          ASSERT_MSG(source_buf_->sgetc() == traits_type::eof(), "invalid zstd file");
-          return traits_type::eof();
+          // end of frame: stop at EOF, or continue to the next frame
+          if (source_buf_->sgetc() == traits_type::eof()) {
+            return traits_type::eof();
+          }
+          to_read_ = ZSTD_initDStream(dstream_);
+          ASSERT_MSG(!ZSTD_isError(to_read_), "ZSTD_initDStream: {}", ZSTD_getErrorName(to_read_));
         }
 
         // read from source buffer
@@ -68,4 +81,205 @@ private:
   ZSTD_inBuffer input_;
   std::size_t to_read_;
 };
+
+/// default size of uncompressed data per zstd frame [byte]
+const std::size_t kZstdFrameSize = 1 << 23;
+
+/// split zstd data [|data|, |data| + |size|) into frames: return list of (position, size)
+inline std::vector<std::pair<std::size_t, std::size_t>> zstd_frames(const char* data,
+                                                                    std::size_t size) {
+  std::vector<std::pair<std::size_t, std::size_t>> frames;
+  for (std::size_t pos = 0; pos < size;) {
+    std::size_t frame_size = ZSTD_findFrameCompressedSize(data + pos, size - pos);
+    ASSERT_MSG(!ZSTD_isError(frame_size), "invalid zstd file: {}", ZSTD_getErrorName(frame_size));
+    frames.emplace_back(pos, frame_size);
+    pos += frame_size;
+  }
+  return frames;
+}
+
+/// decompress zstd data [|data|, |data| + |size|).
+/// independent frames are decompressed in parallel, so data compressed by |zstd_compress| or
+/// `pzstd` is decoded by all cores. `zstd` writes a single frame even with `-T0`, which is
+/// decoded by one thread (consider |zstd_decode_filter_buf| to avoid holding the whole output).
+/// peak memory is the decompressed size, plus a temporary buffer for each frame without content
+/// size in its header (e.g., written by streaming compression), which is freed once copied.
+/// @param num_threads the number of threads: when specified 0, set automatically
+inline std::vector<char> zstd_decompress(const char* data, std::size_t size,
+                                         int num_threads = 0) {
+  auto frames = zstd_frames(data, size);
+  if (num_threads == 0) {
+    num_threads = default_num_threads(frames.size(), 1);
+  }
+
+  using dctx_ptr = std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)>;
+  std::vector<dctx_ptr> contexts;
+  for (int i [[maybe_unused]] : irange(num_threads)) {
+    contexts.emplace_back(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  }
+
+  // frames without content size in their headers are decoded into temporary buffers first
+  std::vector<std::size_t> positions(frames.size() + 1);
+  std::vector<bool> is_streamed(frames.size());
+  std::vector<std::vector<char>> streamed(frames.size());
+  for (std::size_t i : irange(frames.size())) {
+    unsigned long long content_size = ZSTD_getFrameContentSize(data + frames[i].first,
+                                                                frames[i].second);
+    ASSERT_MSG(content_size != ZSTD_CONTENTSIZE_ERROR, "invalid zstd file");
+    is_streamed[i] = content_size == ZSTD_CONTENTSIZE_UNKNOWN;
+    positions[i + 1] = is_streamed[i] ? 0 : content_size;
+  }
+
+  parallel_for(
+      frames.size(), 1,
+      fn(i, t) {
+        if (!is_streamed[i]) return;
+        ZSTD_DCtx_reset(contexts[t].get(), ZSTD_reset_session_only);
+        ZSTD_inBuffer input = {data + frames[i].first, frames[i].second, 0};
+        std::vector<char>& out = streamed[i];
+        std::size_t ret = 1;
+        while (ret != 0) {
+          out.resize(out.size() + ZSTD_DStreamOutSize());
+          ZSTD_outBuffer output = {out.data(), out.size(), out.size() - ZSTD_DStreamOutSize()};
+          ret = ZSTD_decompressStream(contexts[t].get(), &output, &input);
+          ASSERT_MSG(!ZSTD_isError(ret), "ZSTD_decompressStream: {}", ZSTD_getErrorName(ret));
+          ASSERT_MSG(ret == 0 || input.pos < input.size || output.pos == output.size,
+                     "premature end of file");
+          out.resize(output.pos);
+        }
+      },
+      num_threads);
+
+  // a single frame needs no concatenation
+  if (frames.size() == 1 && is_streamed[0]) {
+    return std::move(streamed[0]);
+  }
+
+  for (std::size_t i : irange(frames.size())) {
+    positions[i + 1] = positions[i] + (is_streamed[i] ? streamed[i].size() : positions[i + 1]);
+  }
+
+  std::vector<char> result(positions.back());
+  parallel_for(
+      frames.size(), 1,
+      fn(i, t) {
+        char* dst = result.data() + positions[i];
+        std::size_t dst_size = positions[i + 1] - positions[i];
+        if (is_streamed[i]) {
+          if (dst_size > 0) std::memcpy(dst, streamed[i].data(), dst_size);
+          std::vector<char>().swap(streamed[i]);
+          return;
+        }
+        std::size_t ret = ZSTD_decompressDCtx(contexts[t].get(), dst, dst_size,
+                                              data + frames[i].first, frames[i].second);
+        ASSERT_MSG(!ZSTD_isError(ret), "ZSTD_decompressDCtx: {}", ZSTD_getErrorName(ret));
+        ASSERT_MSG(ret == dst_size, "invalid zstd file");
+      },
+      num_threads);
+
+  return result;
+}
+
+/// compress [|data|, |data| + |size|) into independent zstd frames in parallel.
+/// output is a valid zstd file, and its frames can be decompressed in parallel
+/// @param level compression level
+/// @param frame_size size of uncompressed data per frame [byte]
+/// @param num_threads the number of threads: when specified 0, set automatically
+inline std::string zstd_compress(const char* data, std::size_t size, int level = 3,
+                                 std::size_t frame_size = kZstdFrameSize, int num_threads = 0) {
+  std::size_t num_frames = (size + frame_size - 1) / frame_size;
+  if (num_threads == 0) {
+    num_threads = default_num_threads(num_frames, 1);
+  }
+
+  using cctx_ptr = std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>;
+  std::vector<cctx_ptr> contexts;
+  for (int i [[maybe_unused]] : irange(num_threads)) {
+    contexts.emplace_back(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+  }
+
+  std::vector<std::string> compressed(num_frames);
+  parallel_for(
+      num_frames, 1,
+      fn(i, t) {
+        std::size_t src_size = std::min(frame_size, size - i * frame_size);
+        compressed[i].resize(ZSTD_compressBound(src_size));
+        std::size_t ret = ZSTD_compressCCtx(contexts[t].get(), compressed[i].data(),
+                                            compressed[i].size(), data + i * frame_size,
+                                            src_size, level);
+        ASSERT_MSG(!ZSTD_isError(ret), "ZSTD_compressCCtx: {}", ZSTD_getErrorName(ret));
+        compressed[i].resize(ret);
+      },
+      num_threads);
+
+  std::string result;
+  for (const auto& frame : compressed) {
+    result += frame;
+  }
+  return result;
+}
+
+/// output filter streambuf which compresses data written to it and passes them to |dest|.
+/// data are buffered up to |kZstdFrameSize| bytes per thread, and then compressed into
+/// independent frames in parallel (see |zstd_compress|); remaining data are compressed on
+/// |pubsync()| (e.g., |std::ostream::flush()|) or destruction.
+/// the buffer starts at one frame and grows as data are written, so small outputs stay cheap.
+class zstd_encode_filter_buf : public std::streambuf {
+public:
+  /// @param level compression level
+  /// @param num_threads the number of threads: when specified 0, set automatically
+  zstd_encode_filter_buf(std::streambuf* dest, int level = 3, int num_threads = 0)
+      : dest_buf_{dest},
+        level_{level},
+        num_threads_{num_threads > 0 ? num_threads : thread_pool::shared().size()},
+        buf_(kZstdFrameSize) {
+    setp(buf_.data(), buf_.data() + buf_.size());
+  }
+
+  zstd_encode_filter_buf(const zstd_encode_filter_buf&) = delete;
+  zstd_encode_filter_buf(zstd_encode_filter_buf&&) = delete;
+  zstd_encode_filter_buf& operator=(const zstd_encode_filter_buf&) = delete;
+  zstd_encode_filter_buf& operator=(zstd_encode_filter_buf&&) = delete;
+
+  virtual ~zstd_encode_filter_buf() { sync(); }
+
+protected:
+  virtual int_type overflow(int_type ch) {
+    std::size_t size = pptr() - pbase();
+    if (buf_.size() < kZstdFrameSize * num_threads_) {
+      buf_.resize(std::min(2 * buf_.size(), kZstdFrameSize * num_threads_));
+      setp(buf_.data(), buf_.data() + buf_.size());
+      for (std::size_t i = 0; i < size; i += std::numeric_limits<int>::max()) {
+        pbump(std::min<std::size_t>(size - i, std::numeric_limits<int>::max()));
+      }
+    } else {
+      compress_buffer();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  virtual int sync() {
+    compress_buffer();
+    return dest_buf_->pubsync();
+  }
+
+private:
+  std::streambuf* const dest_buf_;
+  const int level_;
+  const int num_threads_;
+  std::vector<char> buf_;
+
+  void compress_buffer() {
+    std::size_t size = pptr() - pbase();
+    if (size == 0) return;
+    std::string compressed = zstd_compress(pbase(), size, level_, kZstdFrameSize, num_threads_);
+    std::streamsize written = dest_buf_->sputn(compressed.data(), compressed.size());
+    ASSERT_MSG(static_cast<std::size_t>(written) == compressed.size(), "write failed");
+    setp(buf_.data(), buf_.data() + buf_.size());
+  }
+};
 }  // namespace bgl
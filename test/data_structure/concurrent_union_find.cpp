@@ -0,0 +1,50 @@
+#include "../extlib/catch.hpp"
+#include "bgl/data_structure/concurrent_union_find.hpp"
+#include "bgl/data_structure/union_find.hpp"
+#include <random>
+using namespace bgl;
+
+TEST_CASE("concurrent union-find", "[data-structure]") {
+  concurrent_union_find<int> small(10);
+  REQUIRE(small.disjoint_count() == 10);
+  REQUIRE(small.unite(2, 9));
+  REQUIRE(small.unite(4, 5));
+  REQUIRE(small.unite(6, 1));
+  REQUIRE(small.unite(5, 2));
+  REQUIRE(!small.unite(9, 4));
+  REQUIRE(small.disjoint_count() == 6);
+  REQUIRE(small.is_same(1, 6));
+  REQUIRE(!small.is_same(1, 2));
+  REQUIRE(small.find(9) == 2);
+  REQUIRE(small.components() == std::vector<int>{0, 1, 2, 3, 2, 2, 1, 7, 8, 2});
+
+  // random pairs merged by multiple threads
+  const int n = 200000;
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> uid(0, n - 1);
+  std::vector<std::pair<int, int>> pairs(n / 2);
+  for (auto &p : pairs) p = {uid(rng), uid(rng)};
+
+  union_find<int> expected(n);
+  for (auto [x, y] : pairs) expected.unite(x, y);
+
+  concurrent_union_find<int> uf(n, 4);
+  parallel_for(
+      pairs.size() / 2, 1024,
+      fn(i, t [[maybe_unused]]) { uf.unite(pairs[i].first, pairs[i].second); }, 4);
+  std::vector<std::pair<int, int>> rest(pairs.begin() + pairs.size() / 2, pairs.end());
+  uf.unite_all(rest, 4);
+  REQUIRE(uf.disjoint_count() == expected.disjoint_count());
+
+  for (int i = 0; i < n; i += 7) {
+    int j = pairs[i % pairs.size()].first;
+    REQUIRE(uf.is_same(i, j) == expected.is_same(i, j));
+  }
+
+  std::vector<int> ids = uf.components(4);
+  for (int i = 0; i < n; ++i) {
+    REQUIRE(ids[i] <= i);
+    REQUIRE(ids[ids[i]] == ids[i]);
+    REQUIRE(expected.is_same(i, ids[i]));
+  }
+}
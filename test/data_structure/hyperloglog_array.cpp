@@ -47,3 +47,51 @@ TEST_CASE("hyperloglog", "[data-structure]") {
     REQUIRE(h[0].count() < 22000);
   }
 }
+
+TEST_CASE("packed hyperloglog", "[data-structure]") {
+  // without saturation, packed registers give the same estimates as |hyperloglog_array|
+  const int n = 20;
+  hyperloglog_array h(n, 10);
+  packed_hyperloglog_array<5> p5(n, 10);
+  packed_hyperloglog_array<6> p6(n, 10);
+  for (int i : irange(n)) {
+    for (int j[[maybe_unused]] : irange(1 << (i % 16))) {
+      std::uint64_t x = bgl_random();
+      h[i].insert(x);
+      p5[i].insert(x);
+      p6[i].insert(x);
+    }
+  }
+  for (int i : irange(n)) {
+    REQUIRE(p5[i].count() == Approx(h[i].count()));
+    REQUIRE(p6[i].count() == Approx(h[i].count()));
+  }
+
+  // merge in a chain to mix registers of various ranks
+  for (int i : irange(1, n)) {
+    h[i].merge(h[i - 1]);
+    p5[i].merge(p5[i - 1]);
+    p6[i].merge(p6[i - 1]);
+    REQUIRE(p5[i].count() == Approx(h[i].count()));
+    REQUIRE(p6[i].count() == Approx(h[i].count()));
+  }
+
+  packed_hyperloglog_array<5> q(p5);
+  REQUIRE(q == p5);
+  q[0] = q[n - 1];
+  REQUIRE(q[0] == p5[n - 1]);
+  REQUIRE(q != p5);
+
+  // 4-bit registers saturate at rank 15, which does not matter for small counts
+  packed_hyperloglog_array<4> p4(2, 12);
+  REQUIRE(p4[0].count() == 0.0);
+  for (int i : irange(100000)) {
+    p4[0].insert(i);
+    p4[1].insert(i + 50000);
+  }
+  REQUIRE(p4[0].count() > 90000);
+  REQUIRE(p4[0].count() < 110000);
+  p4[0].merge(p4[1]);
+  REQUIRE(p4[0].count() > 135000);
+  REQUIRE(p4[0].count() < 165000);
+}
@@ -20,4 +20,12 @@ TEST_CASE("union-find", "[data-structure]") {
 
   uf.unite(9, 5);
   REQUIRE(uf.disjoint_count() == 6);
+  REQUIRE(uf.set_size(9) == 4);
+  REQUIRE(uf.set_size(7) == 1);
+
+  uf.extend(12);
+  REQUIRE(uf.element_count() == 12);
+  REQUIRE(uf.disjoint_count() == 8);
+  REQUIRE(uf.unite(11, 1) == true);
+  REQUIRE(uf.set_size(6) == 3);
 }
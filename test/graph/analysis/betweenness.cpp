@@ -0,0 +1,140 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/betweenness.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+using namespace bgl;
+
+namespace {
+/// compute betweenness centrality from all-pairs distances and numbers of shortest paths
+template <typename GraphType>
+std::vector<double> naive_betweenness(const GraphType &g) {
+  using weight_type = typename GraphType::weight_type;
+  const node_t n = g.num_nodes();
+  const weight_type inf = std::numeric_limits<weight_type>::max();
+  std::vector<std::vector<weight_type>> dist(n, std::vector<weight_type>(n, inf));
+  for (node_t v : g.nodes()) {
+    dist[v][v] = 0;
+    for (const auto &e : g.edges(v)) dist[v][to(e)] = std::min(dist[v][to(e)], weight(e));
+  }
+  for (node_t k : g.nodes()) {
+    for (node_t i : g.nodes()) {
+      for (node_t j : g.nodes()) {
+        if (dist[i][k] != inf && dist[k][j] != inf) {
+          dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+        }
+      }
+    }
+  }
+
+  // count shortest paths in increasing order of distance from each source
+  std::vector<std::vector<double>> sigma(n, std::vector<double>(n));
+  for (node_t s : g.nodes()) {
+    std::vector<node_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), fn(a, b) { return dist[s][a] < dist[s][b]; });
+    sigma[s][s] = 1.0;
+    for (node_t v : order) {
+      if (dist[s][v] == inf) break;
+      for (const auto &e : g.edges(v)) {
+        if (dist[s][v] + weight(e) == dist[s][to(e)]) sigma[s][to(e)] += sigma[s][v];
+      }
+    }
+  }
+
+  std::vector<double> result(n);
+  for (node_t s : g.nodes()) {
+    for (node_t t : g.nodes()) {
+      if (s == t || dist[s][t] == inf) continue;
+      for (node_t v : g.nodes()) {
+        if (v == s || v == t || dist[s][v] == inf || dist[v][t] == inf) continue;
+        if (dist[s][v] + dist[v][t] == dist[s][t]) {
+          result[v] += sigma[s][v] * sigma[v][t] / sigma[s][t];
+        }
+      }
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST_CASE("betweenness centrality", "[analysis]") {
+  {
+    graph g = gen::path(10);
+    betweenness_centrality<graph> bc(g, g, 2);
+    std::vector<double> scores = bc.exact();
+    for (node_t v : g.nodes()) REQUIRE(scores[v] == Approx(2.0 * v * (9 - v)));
+  }
+  {
+    graph g = gen::star(10);
+    betweenness_centrality<graph> bc(g, g, 2);
+    std::vector<double> scores = bc.exact();
+    REQUIRE(scores[0] == Approx(9.0 * 8.0));
+    for (node_t v = 1; v < 10; ++v) REQUIRE(scores[v] == 0.0);
+  }
+
+  // directed graph with unreachable pairs and many shortest paths
+  graph g(80, gen::erdos_renyi(70, 3).get_edge_list());
+  for (node_t v = 0; v < 70; v += 7) g.add_edge(70 + v / 7, v);
+  graph gt = g.transposed();
+  std::vector<double> expected = naive_betweenness(g);
+  for (int num_threads : {1, 4}) {
+    betweenness_centrality<graph> bc(g, gt, num_threads);
+    std::vector<double> exact = bc.exact();
+    std::vector<double> sampled = bc.sample_sources(g.num_nodes());
+    REQUIRE(exact.size() == expected.size());
+    REQUIRE(sampled.size() == expected.size());
+    for (node_t v : g.nodes()) {
+      INFO("num_threads = " << num_threads << ", v = " << v);
+      REQUIRE(exact[v] == Approx(expected[v]).margin(1e-9));
+      REQUIRE(sampled[v] == Approx(expected[v]).margin(1e-9));
+    }
+  }
+
+  // weighted graph with ties of distances
+  edge_list<weighted_edge_t<int>> es;
+  for (const auto &[u, v] : g.get_edge_list()) {
+    es.emplace_back(u, weighted_edge_t<int>{v, 1 + (u + v) % 3});
+  }
+  wgraph<int> wg(es);
+  wgraph<int> wgt = wg.transposed();
+  betweenness_centrality<wgraph<int>> wbc(wg, wgt, 4);
+  std::vector<double> wexact = wbc.exact();
+  std::vector<double> wexpected = naive_betweenness(wg);
+  REQUIRE(wexact.size() == wexpected.size());
+  for (node_t v : wg.nodes()) {
+    INFO("v = " << v);
+    REQUIRE(wexact[v] == Approx(wexpected[v]).margin(1e-9));
+  }
+}
+
+TEST_CASE("betweenness centrality sampling", "[analysis]") {
+  graph g = gen::erdos_renyi(300, 4).make_undirected().simplify();
+  const double n = g.num_nodes();
+  betweenness_centrality<graph> bc(g, g, 4);
+  std::vector<double> exact = bc.exact();
+
+  // source sampling from half of the nodes
+  std::vector<double> sampled = bc.sample_sources(150);
+  double error = 0.0, total = 0.0;
+  for (node_t v : g.nodes()) {
+    error += std::abs(sampled[v] - exact[v]);
+    total += exact[v];
+  }
+  REQUIRE(error < 0.2 * total);
+
+  // path sampling bounds the maximum error
+  const double epsilon = 0.01;
+  std::vector<double> approx = bc.approximate(epsilon, 0.01);
+  REQUIRE(bc.num_samples() > 0);
+  REQUIRE(bc.num_samples() < 100000);
+  for (node_t v : g.nodes()) REQUIRE(std::abs(approx[v] - exact[v]) <= epsilon * n * (n - 1));
+
+  // the result does not depend on the number of threads
+  betweenness_centrality<graph> bc1(g, g, 1);
+  bgl_random.seed(42);
+  std::vector<double> approx4 = bc.approximate(epsilon);
+  bgl_random.seed(42);
+  REQUIRE(bc1.approximate(epsilon) == approx4);
+}
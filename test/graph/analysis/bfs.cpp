@@ -0,0 +1,73 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/bfs.hpp"
+#include "bgl/graph/analysis/multi_source_bfs.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+using namespace bgl;
+
+TEST_CASE("direction-optimizing bfs", "[analysis]") {
+  // random graph with a directed hub and isolated nodes
+  graph g(20010, gen::erdos_renyi(20000, 10).get_edge_list());
+  for (node_t v = 1; v < 20000; v += 3) g.add_edge(0, v);
+  g.simplify();
+  graph gt = g;
+  gt.transpose();
+
+  direction_optimizing_bfs<graph> bfs(g, gt, 4);
+  for (node_t s : {0, 1, 2, 12345}) {
+    bfs.run(s, true);
+    const auto &dist = bfs.distances();
+    REQUIRE(dist == single_source_distance(g, s));
+
+    REQUIRE(bfs.parents()[s] == s);
+    for (node_t v : g.nodes()) {
+      node_t p = bfs.parents()[v];
+      if (v == s) continue;
+      INFO("s = " << s << ", v = " << v);
+      if (p == kInvalidNode) {
+        REQUIRE(dist[v] == std::numeric_limits<int>::max());
+      } else {
+        REQUIRE(g.is_adjacent(p, v));
+        REQUIRE(dist[p] + 1 == dist[v]);
+      }
+    }
+  }
+
+  graph g2 = gen::dir_cycle(100);
+  graph g2t = g2;
+  g2t.transpose();
+  REQUIRE(parallel_single_source_distance(g2, g2t, 5) == single_source_distance(g2, 5));
+
+  csr_graph c = g;
+  REQUIRE(parallel_single_source_distance(c, c.transposed(), 7) == single_source_distance(g, 7));
+}
+
+TEST_CASE("multi-source bfs", "[analysis]") {
+  graph g(3010, gen::erdos_renyi(3000, 4).get_edge_list());
+  for (node_t v = 1; v < 3000; v += 7) g.add_edge(0, v);
+  g.simplify();
+  graph gt = g;
+  gt.transpose();
+
+  std::vector<node_t> sources;
+  for (node_t s = 0; s < 3010; s += 10) sources.push_back(s);
+  auto dists = multi_source_distance(g, gt, sources);
+  REQUIRE(dists.size() == sources.size());
+  for (std::size_t i : irange(sources.size())) {
+    INFO("source = " << sources[i]);
+    REQUIRE(dists[i] == single_source_distance(g, sources[i]));
+  }
+
+  multi_source_bfs<graph, 1> bfs(g, gt, 2);
+  std::atomic<std::size_t> num_reached = 0;
+  bfs.run({0, 0, 5}, fn(v [[maybe_unused]], i [[maybe_unused]], d [[maybe_unused]]) {
+    num_reached++;
+  });
+  std::size_t expected = 0;
+  for (node_t s : {0, 0, 5}) {
+    auto d = single_source_distance(g, s);
+    expected += d.size() - std::count(d.begin(), d.end(), std::numeric_limits<int>::max());
+  }
+  REQUIRE(num_reached == expected);
+}
@@ -0,0 +1,52 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/closeness.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include <algorithm>
+using namespace bgl;
+
+namespace {
+/// compute normalized closeness centrality of all nodes by BFS from each node
+std::vector<std::pair<node_t, double>> naive_closeness(const graph &g) {
+  const node_t n = g.num_nodes();
+  std::vector<std::pair<node_t, double>> result;
+  for (node_t v : g.nodes()) {
+    std::uint64_t sum = 0;
+    bool reachable = true;
+    for (int d : single_source_distance(g, v)) {
+      reachable &= d != std::numeric_limits<int>::max();
+      sum += d;
+    }
+    result.emplace_back(v, reachable && sum > 0 ? static_cast<double>(n - 1) / sum : 0.0);
+  }
+  std::stable_sort(result.begin(), result.end(), fn(a, b) { return a.second > b.second; });
+  return result;
+}
+}  // namespace
+
+TEST_CASE("top-k normalized closeness", "[analysis]") {
+  graph g = gen::erdos_renyi(400, 4);
+  g.make_undirected().simplify();
+  for (node_t v = 1; v < 400; ++v) g.add_edge(v - 1, v).add_edge(v, v - 1);
+  std::vector<std::pair<node_t, double>> expected = naive_closeness(g);
+
+  for (int num_threads : {1, 4}) {
+    for (node_t k : {1, 10, 400, 500}) {
+      INFO("num_threads = " << num_threads << ", k = " << k);
+      auto result = top_k_normalized_closeness(g, k, num_threads);
+      REQUIRE(result.size() == std::min<node_t>(k, 400));
+      for (std::size_t i = 0; i < result.size(); ++i) {
+        REQUIRE(result[i].first == expected[i].first);
+        REQUIRE(result[i].second == Approx(expected[i].second));
+      }
+    }
+  }
+
+  // directed: only nodes reaching every node have positive normalized closeness
+  graph c(11, gen::dir_cycle(10).get_edge_list());
+  c.add_edge(9, 10);
+  auto result = top_k_normalized_closeness(c, 11);
+  REQUIRE(result.size() == 11);
+  REQUIRE(result[0].second > 0.0);
+  REQUIRE(result[10] == std::make_pair<node_t, double>(10, 0.0));
+}
@@ -1,7 +1,26 @@
 #include "../extlib/catch.hpp"
+#include "bgl/data_structure/union_find.hpp"
 #include "bgl/graph/analysis/connectivity.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
 using namespace bgl;
 
+namespace {
+/// renumber component IDs in order of their smallest node
+std::pair<node_t, std::vector<node_t>> canonicalize(std::pair<node_t, std::vector<node_t>> p) {
+  std::vector<node_t> id_map(p.first, kInvalidNode);
+  node_t num_components = 0;
+  for (node_t &id : p.second) {
+    if (id_map[id] == kInvalidNode) id_map[id] = num_components++;
+    id = id_map[id];
+  }
+  return p;
+}
+}  // namespace
+
 TEST_CASE("connectivity", "[analysis]") {
   unweighted_adjacency_list adj = {{1}, {2}, {0}, {1, 2, 5}, {2, 6}, {3, 4}, {4}, {5, 6}};
   graph g = adj;
@@ -49,4 +68,86 @@ TEST_CASE("connectivity", "[analysis]") {
   extract_largest_scc(g);
   REQUIRE(g.num_nodes() == 3);
   REQUIRE(g.num_edges() == 4);
+
+  // tie of sizes: the SCC containing the smallest node is extracted
+  graph h = unweighted_adjacency_list{{2}, {4}, {3}, {5}, {6}, {2}, {1}};
+  extract_largest_scc(h);
+  REQUIRE(h.num_nodes() == 3);
+  REQUIRE(h.num_edges() == 3);
+  REQUIRE(h.is_adjacent(0, 1));
+  REQUIRE(h.is_adjacent(1, 2));
+  REQUIRE(h.is_adjacent(2, 0));
+}
+
+TEST_CASE("parallel scc", "[analysis]") {
+  // chains of cycles (DAG of SCCs) with a random giant SCC: exercises all steps of Multistep
+  const node_t num_cycles = 1000, cycle_size = 30, num_chained = num_cycles * cycle_size;
+  graph g(num_chained + 20000, gen::erdos_renyi(20000, 3).get_edge_list());
+  for (node_t v = 0; v < num_chained + 20000; ++v) {
+    if (v < num_chained) {
+      g.add_edge(v, v % cycle_size + 1 == cycle_size ? v + 1 - cycle_size : v + 1);
+    }
+    if (v + 7 * cycle_size < num_chained) g.add_edge(v, v + 7 * cycle_size);
+  }
+  graph gt = g.transposed();
+
+  auto expected = canonicalize(strongly_connected_components(g));
+  REQUIRE(parallel_strongly_connected_components(g, gt, 4) == expected);
+  REQUIRE(parallel_strongly_connected_components(g, gt, 1) == expected);
+  std::vector<node_t> num_nodes(expected.first);
+  for (node_t id : expected.second) num_nodes[id]++;
+  REQUIRE(extract_largest_scc(g, gt, 4).num_nodes() ==
+          *std::max_element(num_nodes.begin(), num_nodes.end()));
+
+  csr_graph c = gen::dir_cycle(100);
+  REQUIRE(parallel_strongly_connected_components(c, c.transposed()).first == 1);
+}
+
+TEST_CASE("parallel scc stress", "[analysis]") {
+  // long cycles with shuffled IDs keep color propagation running for many rounds, and one-way
+  // edges between cycles make colors of different cycles race on the same nodes
+  const node_t num_cycles = 20, cycle_size = 2000, n = num_cycles * cycle_size;
+  std::vector<node_t> ids(n);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::mt19937 rng(12345);
+  std::shuffle(ids.begin(), ids.end(), rng);
+  edge_list<unweighted_edge_t> es;
+  for (node_t v : irange(n)) {
+    es.emplace_back(ids[v], ids[v % cycle_size + 1 == cycle_size ? v + 1 - cycle_size : v + 1]);
+    if (v % 100 == 0 && v + cycle_size + 50 < n) {
+      es.emplace_back(ids[v], ids[v + cycle_size + 50]);
+    }
+  }
+  graph g(n, es);
+  graph gt = g.transposed();
+
+  auto expected = canonicalize(strongly_connected_components(g));
+  REQUIRE(expected.first == num_cycles);
+  for (int iter : irange(30)) {
+    INFO("iter = " << iter);
+    REQUIRE(parallel_strongly_connected_components(g, gt, 8) == expected);
+  }
+}
+
+TEST_CASE("parallel wcc", "[analysis]") {
+  // sparse directed random graph: a giant component with many small ones
+  graph g(100000, gen::erdos_renyi(100000, 1.2).get_edge_list());
+  union_find<node_t> uf(g.num_nodes());
+  for (node_t v : g.nodes()) {
+    for (node_t w : g.neighbors(v)) uf.unite(v, w);
+  }
+  std::vector<node_t> ids = uf.components();
+  auto expected = canonicalize({g.num_nodes(), ids});
+  expected.first = uf.disjoint_count();
+
+  REQUIRE(weakly_connected_components(g, 4) == expected);
+  REQUIRE(weakly_connected_components(g, 1) == expected);
+  graph gt = g.transposed();
+  REQUIRE(weakly_connected_components(g, gt, 4) == expected);
+
+  // undirected graph passed as its own transposed graph
+  g.make_undirected();
+  REQUIRE(weakly_connected_components(g, g, 4) == expected);
+  csr_graph c = gen::grid(50, 40);
+  REQUIRE(weakly_connected_components(c).first == 1);
 }
@@ -0,0 +1,60 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/core_decomposition.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+using namespace bgl;
+
+namespace {
+/// compute core numbers by removing a node of the minimum degree one by one
+std::vector<node_t> naive_core_numbers(const graph &g) {
+  std::vector<node_t> degrees(g.num_nodes()), cores(g.num_nodes(), kInvalidNode);
+  for (node_t v : g.nodes()) degrees[v] = g.outdegree(v);
+  node_t k = 0;
+  for (node_t i = 0; i < g.num_nodes(); ++i) {
+    node_t u = kInvalidNode;
+    for (node_t v : g.nodes()) {
+      if (cores[v] == kInvalidNode && (u == kInvalidNode || degrees[v] < degrees[u])) u = v;
+    }
+    k = std::max(k, degrees[u]);
+    cores[u] = k;
+    for (node_t w : g.neighbors(u)) --degrees[w];
+  }
+  return cores;
+}
+}  // namespace
+
+TEST_CASE("core decomposition", "[analysis]") {
+  REQUIRE(core_numbers(gen::complete(10)) == std::vector<node_t>(10, 9));
+  REQUIRE(core_numbers(gen::star(10)) == std::vector<node_t>(10, 1));
+
+  // random graph with a planted dense part and isolated nodes
+  graph g(2010, gen::erdos_renyi(2000, 6).get_edge_list());
+  for (node_t u = 0; u < 30; ++u) {
+    for (node_t v = u + 1; v < 30; ++v) g.add_edge(u * 50, v * 50);
+  }
+  g.make_undirected().simplify();
+  auto expected = naive_core_numbers(g);
+
+  for (int num_threads : {1, 4}) {
+    INFO("num_threads = " << num_threads);
+    auto [cores, order] = core_decomposition(g, num_threads);
+    REQUIRE(cores == expected);
+
+    // every node has at most its core number of neighbors after itself
+    std::vector<node_t> rank(g.num_nodes(), kInvalidNode);
+    for (node_t i : irange(order.size())) rank[order[i]] = i;
+    REQUIRE(order.size() == g.num_nodes());
+    for (node_t v : g.nodes()) {
+      node_t num_later = 0;
+      for (node_t w : g.neighbors(v)) num_later += rank[w] > rank[v];
+      REQUIRE(num_later <= cores[v]);
+    }
+  }
+
+  csr_graph c = g;
+  REQUIRE(core_numbers(c) == expected);
+  node_t max_core = *std::max_element(expected.begin(), expected.end());
+  extract_k_core(g, max_core);
+  REQUIRE(g.num_nodes() == std::count(expected.begin(), expected.end(), max_core));
+  for (node_t v : g.nodes()) REQUIRE(g.outdegree(v) >= max_core);
+}
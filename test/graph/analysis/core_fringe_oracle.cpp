@@ -0,0 +1,36 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/core_fringe_oracle.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+using namespace bgl;
+
+namespace {
+template <typename GraphType>
+void check_oracle(const GraphType &g, core_fringe_oracle<GraphType> &oracle) {
+  for (node_t s = 0; s < g.num_nodes(); s += 101) {
+    INFO("s = " << s);
+    auto expected = single_source_distance(g, s);
+    std::vector<typename GraphType::weight_type> actual(g.num_nodes());
+    for (node_t t : g.nodes()) actual[t] = oracle.query(s, t);
+    REQUIRE(actual == expected);
+  }
+}
+}  // namespace
+
+TEST_CASE("core-fringe oracle", "[analysis]") {
+  // sparse random graph (tree-like fringe around a core) with isolated nodes
+  graph g(2010, gen::erdos_renyi(2000, 2.5).get_edge_list());
+  g.make_undirected();
+  for (int width : {0, 2, 5, 1000}) {
+    INFO("width = " << width);
+    core_fringe_oracle<graph> oracle(g, width);
+    check_oracle(g, oracle);
+    REQUIRE(oracle.num_fringe_nodes() + oracle.core_graph().num_nodes() == g.num_nodes());
+  }
+
+  auto weight_fn = fn(u, v) { return double((u * 7 + v * 7) % 21) / 4; };
+  wgraph<double> wg = convert_to_weighted<double>(gen::grid(30, 20), weight_fn);
+  core_fringe_oracle<wgraph<double>> woracle(wg, 4);
+  REQUIRE(woracle.num_fringe_nodes() > 0);
+  check_oracle(wg, woracle);
+}
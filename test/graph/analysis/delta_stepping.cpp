@@ -0,0 +1,53 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/delta_stepping.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/random.hpp"
+#include <random>
+using namespace bgl;
+
+namespace {
+template <typename WeightType>
+weighted_edge_list<WeightType> random_weighted_edges(node_t n, double avg_deg, int max_weight) {
+  std::uniform_int_distribution<int> uid(0, max_weight);
+  weighted_edge_list<WeightType> es;
+  for (const auto &[u, v] : gen::erdos_renyi(n, avg_deg).get_edge_list()) {
+    // weights are multiples of 1/4 so that floating-point distances are exact
+    es.emplace_back(u, weighted_edge_t<WeightType>{v, uid(bgl_random) / WeightType(4)});
+  }
+  return es;
+}
+}  // namespace
+
+TEST_CASE("delta-stepping", "[analysis]") {
+  wgraph<double> g(10010, random_weighted_edges<double>(10000, 8, 100));
+  csr_wgraph<double> csr_g(g);
+  for (double delta : {0.0, 0.25, 3.0, 1000.0}) {
+    delta_stepping<wgraph<double>> sssp(g, delta, 4);
+    delta_stepping<csr_wgraph<double>> csr_sssp(csr_g, delta, 3);
+    for (node_t s : {0, 1, 9999, 10005}) {
+      auto expected = single_source_distance(g, s);
+      sssp.run(s);
+      REQUIRE(sssp.distances() == expected);
+      csr_sssp.run(s);
+      REQUIRE(csr_sssp.distances() == expected);
+    }
+  }
+
+  wgraph<int> gi(5000, random_weighted_edges<int>(5000, 4, 4000));
+  REQUIRE(delta_stepping<wgraph<int>>(gi).delta() > 0);
+  for (int delta : {0, 1, 100}) {
+    REQUIRE(delta_stepping_distance(gi, 42, delta) == single_source_distance(gi, 42));
+  }
+
+  // distances far beyond the range of cyclic buckets
+  auto weight_fn = fn(u, v) { return 0.25 + (u + v) % 3; };
+  wgraph<double> wp = convert_to_weighted<double>(gen::path(10000), weight_fn);
+  for (double delta : {0.0, 0.25}) {
+    REQUIRE(delta_stepping_distance(wp, 0, delta, 4) == single_source_distance(wp, 0));
+  }
+
+  graph g2 = gen::dir_cycle(100);
+  REQUIRE(delta_stepping_distance(g2, 5) == single_source_distance(g2, 5));
+}
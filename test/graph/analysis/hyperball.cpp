@@ -0,0 +1,62 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/hyperball.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include <cmath>
+using namespace bgl;
+
+TEST_CASE("hyperball centralities", "[analysis]") {
+  // two components of sizes 300 and 10
+  graph g(310, gen::erdos_renyi(300, 5).get_edge_list());
+  for (node_t v = 300; v < 309; ++v) g.add_edge(v, v + 1);
+  g.make_undirected().simplify();
+  const node_t n = g.num_nodes();
+
+  std::vector<double> reachable(n), sum_of_distances(n), harmonic(n);
+  std::vector<double> distribution(1);
+  for (node_t v : g.nodes()) {
+    std::vector<int> dist = single_source_distance(g, v);
+    for (node_t w : g.nodes()) {
+      if (dist[w] == std::numeric_limits<int>::max()) continue;
+      const node_t d = dist[w];
+      reachable[v] += 1;
+      sum_of_distances[v] += d;
+      if (d > 0) harmonic[v] += 1.0 / d;
+      if (distribution.size() <= d) distribution.resize(d + 1);
+      distribution[d] += 1;
+    }
+  }
+
+  for (int num_threads : {1, 4}) {
+    INFO("num_threads = " << num_threads);
+    geometric_centralities result = hyperball_centralities(g, 12, 100, num_threads);
+    REQUIRE(result.distance_distribution.size() == distribution.size());
+    REQUIRE(result.distance_distribution[0] == Approx(n));
+    double total = 0.0, expected_total = 0.0;
+    for (double c : result.distance_distribution) total += c;
+    for (double c : distribution) expected_total += c;
+    REQUIRE(total == Approx(expected_total).epsilon(0.05));
+
+    // HyperLogLog with 2^12 registers has the relative error of about 1.6%
+    for (node_t v : g.nodes()) {
+      REQUIRE(result.reachable[v] == Approx(reachable[v]).epsilon(0.1));
+      REQUIRE(result.sum_of_distances[v] == Approx(sum_of_distances[v]).epsilon(0.1));
+      REQUIRE(result.harmonic[v] == Approx(harmonic[v]).epsilon(0.1));
+      REQUIRE(result.closeness(v) == Approx(1.0 / sum_of_distances[v]).epsilon(0.1));
+      REQUIRE(result.lin(v) ==
+              Approx(reachable[v] * reachable[v] / sum_of_distances[v]).epsilon(0.2));
+    }
+  }
+
+  // 6-bit registers never saturate and give the same estimates
+  geometric_centralities unpacked = hyperball_centralities(g, 8, 100, 4);
+  geometric_centralities packed = hyperball_centralities<packed_hyperloglog_array<6>>(g, 8, 100, 4);
+  REQUIRE(packed.sum_of_distances == unpacked.sum_of_distances);
+  REQUIRE(packed.distance_distribution.size() == unpacked.distance_distribution.size());
+
+  // isolated node
+  geometric_centralities result = hyperball_centralities(graph(1), 5);
+  REQUIRE(result.closeness(0) == 0.0);
+  REQUIRE(result.lin(0) == 1.0);
+  REQUIRE(result.harmonic[0] == 0.0);
+}
@@ -0,0 +1,42 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/connectivity.hpp"
+#include "bgl/graph/analysis/incremental_connectivity.hpp"
+#include "bgl/graph/generator/all.hpp"
+using namespace bgl;
+
+TEST_CASE("incremental connectivity", "[analysis]") {
+  incremental_connectivity ic;
+  REQUIRE(ic.num_nodes() == 0);
+  REQUIRE(ic.largest_component_size() == 0);
+  REQUIRE(ic.add_edge(3, 1));
+  REQUIRE(ic.num_nodes() == 4);
+  REQUIRE(ic.add_edge(1, 2));
+  REQUIRE(!ic.add_edge(2, 3));
+  REQUIRE(ic.num_edges() == 3);
+  REQUIRE(ic.component_size(2) == 3);
+  REQUIRE(ic.largest_component_size() == 3);
+  REQUIRE(ic.snapshot() == std::pair<node_t, std::vector<node_t>>{2, {0, 1, 1, 1}});
+
+  // feed edges of a random graph in batches and compare with batch recomputation
+  graph g(30000);
+  unweighted_edge_list es = gen::erdos_renyi(30000, 1.5).get_edge_list();
+  incremental_connectivity stream(100);
+  const std::size_t batch_size = 10000;
+  for (std::size_t first = 0; first < es.size(); first += batch_size) {
+    unweighted_edge_list batch(es.begin() + first,
+                               es.begin() + std::min(first + batch_size, es.size()));
+    INFO("first = " << first);
+    stream.add_edges(batch);
+    for (const auto &e : batch) g.add_edge(e.first, e.second);
+    stream.add_nodes(g.num_nodes());
+    auto expected = weakly_connected_components(g);
+    REQUIRE(stream.snapshot() == expected);
+    REQUIRE(stream.num_components() == expected.first);
+
+    std::vector<node_t> sizes(expected.first);
+    for (node_t id : expected.second) ++sizes[id];
+    REQUIRE(stream.largest_component_size() == *std::max_element(sizes.begin(), sizes.end()));
+    REQUIRE(stream.component_size(stream.largest_component_node()) ==
+            stream.largest_component_size());
+  }
+}
@@ -0,0 +1,68 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/pagerank.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include <cmath>
+using namespace bgl;
+
+TEST_CASE("pagerank", "[analysis]") {
+  // directed random graph: nodes of the last 10 are dangling
+  graph g(310, gen::erdos_renyi(300, 3).get_edge_list());
+  g.add_edge(0, 0);
+  graph gt = g.transposed();
+  const node_t n = g.num_nodes();
+  pagerank_solver<graph> solver(g, gt, 0.85, 4);
+
+  real_vector pr = solver.pagerank(1e-12, 1000);
+  REQUIRE(solver.residual() <= 1e-12);
+  REQUIRE(solver.num_iterations() > 1);
+  REQUIRE(pr.sum() == Approx(1.0));
+  REQUIRE(pr[305] == Approx(pr[306]));
+
+  // the uniform teleport vector gives PageRank
+  real_vector uniform(n, 1.0 / n);
+  REQUIRE((solver.personalized_pagerank(uniform, 1e-12, 1000) - pr).norm() < 1e-12);
+
+  solver.prepare_exact(8);
+  for (node_t seed : {0, 1, 150, 305}) {
+    INFO("seed = " << seed);
+    real_vector teleport(n);
+    teleport[seed] = 1.0;
+    real_vector expected = solver.personalized_pagerank(teleport, 1e-13, 1000);
+    REQUIRE(expected.sum() == Approx(1.0));
+
+    real_vector exact = solver.exact_personalized_pagerank(seed);
+    REQUIRE(solver.num_iterations() > 0);
+    REQUIRE(solver.residual() < 1e-9);
+    REQUIRE((exact - expected).norm() < 1e-9);
+
+    const double epsilon = 1e-6;
+    real_vector approx(n);
+    for (auto [v, x] : solver.forward_push(seed, epsilon)) approx[v] = x;
+    REQUIRE(solver.num_pushes() > 0);
+    REQUIRE(solver.residual() <= epsilon * (g.num_edges() + n));
+    double error = 0.0;
+    for (node_t v : g.nodes()) {
+      REQUIRE(approx[v] <= expected[v] + 1e-12);
+      error += expected[v] - approx[v];
+    }
+    REQUIRE(std::abs(error - solver.residual()) < 1e-9);
+  }
+
+  // GMRES stops after |restart| * |max_iter| iterations
+  solver.exact_personalized_pagerank(0, 1e-15, 2, 1);
+  REQUIRE(solver.num_iterations() <= 2);
+
+  // batched forward push gives the same results as single seeds
+  std::vector<node_t> seeds = {3, 5, 8, 13, 21, 34, 55, 89};
+  auto batch = solver.forward_push(seeds, 1e-5);
+  for (std::size_t i : irange(seeds.size())) {
+    REQUIRE(batch[i] == solver.forward_push(seeds[i], 1e-5));
+  }
+
+  csr_graph c = gen::dir_cycle(10);
+  csr_graph ct = c.transposed();
+  pagerank_solver<csr_graph> cycle(c, ct);
+  real_vector cpr = cycle.pagerank();
+  for (node_t v : c.nodes()) REQUIRE(std::abs(cpr[v] - 0.1) < 1e-9);
+}
@@ -0,0 +1,71 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/point_to_point.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/random.hpp"
+#include <random>
+using namespace bgl;
+
+namespace {
+template <typename GraphType>
+void check_queries(const GraphType &g, point_to_point_query<GraphType> &query,
+                   const std::vector<node_t> &sources) {
+  using weight_type = typename GraphType::weight_type;
+  for (node_t s : sources) {
+    auto expected = single_source_distance(g, s);
+    for (node_t t = 0; t < g.num_nodes(); t += 37) {
+      INFO("s = " << s << ", t = " << t);
+      weight_type d = query.query(s, t, true);
+      REQUIRE(d == expected[t]);
+      const auto &path = query.path();
+      if (d == std::numeric_limits<weight_type>::max()) {
+        REQUIRE(path.empty());
+        continue;
+      }
+      REQUIRE(!path.empty());
+      REQUIRE(path.front() == s);
+      REQUIRE(path.back() == t);
+      weight_type length = 0;
+      for (std::size_t i = 1; i < path.size(); ++i) {
+        auto w = g.get_weight(path[i - 1], path[i]);
+        REQUIRE(w.has_value());
+        length += *w;
+      }
+      REQUIRE(length == d);
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("point-to-point query", "[analysis]") {
+  // directed random graph with isolated nodes
+  graph g(5010, gen::erdos_renyi(5000, 3).get_edge_list());
+  g.simplify();
+  graph gt = g;
+  gt.transpose();
+  std::vector<node_t> sources = {0, 1, 4999, 5003};
+
+  point_to_point_query<graph> bfs(g, gt);
+  check_queries(g, bfs, sources);
+  point_to_point_query<graph> alt(g, gt, 4);
+  REQUIRE(alt.landmarks().size() == 4);
+  check_queries(g, alt, sources);
+
+  std::uniform_int_distribution<int> uid(0, 40);
+  wgraph<double> wg = convert_to_weighted<double>(g, fn(u [[maybe_unused]], v [[maybe_unused]]) {
+    return uid(bgl_random) / 4.0;
+  });
+  wgraph<double> wgt = wg;
+  wgt.transpose();
+  point_to_point_query<wgraph<double>> dijkstra(wg, wgt);
+  check_queries(wg, dijkstra, sources);
+  point_to_point_query<wgraph<double>> walt(wg, wgt);
+  walt.set_landmarks({2, 3, 5000});
+  check_queries(wg, walt, sources);
+
+  csr_graph c = gen::grid(30, 30);
+  point_to_point_query<csr_graph> grid_alt(c, c, 2);
+  check_queries(c, grid_alt, {0, 465});
+  REQUIRE(point_to_point_distance(c, c, 0, 899) == 58);
+}
@@ -0,0 +1,68 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/pruned_landmark_labeling.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/util/random.hpp"
+#include <random>
+#include <sstream>
+using namespace bgl;
+
+namespace {
+template <typename GraphType>
+void check_index(const GraphType &g, const pruned_landmark_labeling<GraphType> &index) {
+  REQUIRE(index.num_nodes() == g.num_nodes());
+  for (node_t s = 0; s < g.num_nodes(); s += 13) {
+    INFO("s = " << s);
+    auto expected = single_source_distance(g, s);
+    std::vector<typename GraphType::weight_type> actual(g.num_nodes());
+    for (node_t t : g.nodes()) actual[t] = index.query(s, t);
+    REQUIRE(actual == expected);
+  }
+}
+}  // namespace
+
+TEST_CASE("pruned landmark labeling", "[analysis]") {
+  // undirected random graph with isolated nodes
+  graph g(2010, gen::erdos_renyi(2000, 3).get_edge_list());
+  g.make_undirected();
+  pruned_landmark_labeling<graph> pll(g, g);
+  REQUIRE(!pll.directed());
+  check_index(g, pll);
+
+  pruned_landmark_labeling<graph> bp(g, g, hub_ordering_by_slashburn(g), 16, 4);
+  REQUIRE(bp.num_bit_parallel_roots() == 16);
+  check_index(g, bp);
+
+  std::stringstream ss;
+  bp.write(ss);
+  auto loaded = pruned_landmark_labeling<graph>::read(ss);
+  REQUIRE(loaded.num_label_entries() == bp.num_label_entries());
+  check_index(g, loaded);
+
+  // directed graph
+  graph dg(1510, gen::erdos_renyi(1500, 3).get_edge_list());
+  dg.simplify();
+  graph dgt = dg.clone().transpose();
+  pruned_landmark_labeling<graph> dpll(dg, dgt);
+  REQUIRE(dpll.directed());
+  check_index(dg, dpll);
+
+  // weighted directed graph
+  std::uniform_int_distribution<int> uid(0, 20);
+  wgraph<int> wg = convert_to_weighted<int>(dg, fn(u [[maybe_unused]], v [[maybe_unused]]) {
+    return uid(bgl_random);
+  });
+  wgraph<int> wgt = wg.clone().transpose();
+  pruned_landmark_labeling<wgraph<int>> wpll(wg, wgt);
+  check_index(wg, wpll);
+  std::stringstream wss;
+  wpll.write(wss);
+  check_index(wg, pruned_landmark_labeling<wgraph<int>>::read(wss));
+
+  csr_graph c = gen::grid(20, 20);
+  pruned_landmark_labeling<csr_graph> grid_pll(c, c, {}, 4);
+  check_index(c, grid_pll);
+  pruned_landmark_labeling<csr_graph> grid_sb_pll(c, c, hub_ordering_by_slashburn(c), 4);
+  check_index(c, grid_sb_pll);
+}
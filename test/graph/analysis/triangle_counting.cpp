@@ -0,0 +1,56 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/clustering_coefficient.hpp"
+#include "bgl/graph/analysis/triangle_counting.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+using namespace bgl;
+
+TEST_CASE("triangle counting", "[analysis]") {
+  REQUIRE(count_triangles(gen::complete(20)) == 20 * 19 * 18 / 6);
+  REQUIRE(count_triangles(gen::grid(10, 10)) == 0);
+
+  // random graph with a hub adjacent to every third node
+  graph g(3001, gen::erdos_renyi(3000, 8).get_edge_list());
+  for (node_t v = 0; v < 3000; v += 3) g.add_edge(3000, v);
+  g.make_undirected().simplify();
+
+  // check each pair of neighbors
+  std::uint64_t expected_total = 0;
+  std::vector<std::uint64_t> expected(g.num_nodes());
+  for (node_t u : g.nodes()) {
+    for (std::size_t i : irange(g.outdegree(u))) {
+      for (std::size_t j : irange(i + 1, g.outdegree(u))) {
+        expected[u] += g.is_adjacent(g.neighbor(u, i), g.neighbor(u, j));
+      }
+    }
+    expected_total += expected[u];
+  }
+  expected_total /= 3;
+
+  REQUIRE(count_triangles(g, 4) == expected_total);
+  REQUIRE(count_triangles_per_node(g, 4) == expected);
+  csr_graph c = g;
+  REQUIRE(count_triangles_per_node(c, 1) == expected);
+
+  std::vector<double> lcc = local_clustering_coefficient(g);
+  for (node_t v : g.nodes()) {
+    double d = g.outdegree(v);
+    if (d < 2) {
+      REQUIRE(lcc[v] == 0.0);
+    } else {
+      REQUIRE(lcc[v] == Approx(expected[v] / (d * (d - 1) / 2)));
+    }
+  }
+
+  std::vector<double> per_degree = clustering_coefficient_per_degree(g, 20);
+  std::vector<double> num_triangles(21), num_wedges(21);
+  for (node_t v : g.nodes()) {
+    std::size_t d = g.outdegree(v);
+    if (d > 20) continue;
+    num_triangles[d] += expected[v];
+    num_wedges[d] += d * (d - 1) / 2.0;
+  }
+  for (std::size_t d : irange(21)) {
+    REQUIRE(per_degree[d] == Approx(num_triangles[d] ? num_triangles[d] / num_wedges[d] : 0.0));
+  }
+}
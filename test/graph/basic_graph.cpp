@@ -19,6 +19,10 @@ TEST_CASE("unweighted graph", "[basic-graph]") {
     std::vector<node_t> edges_1 = {2};
     REQUIRE(std::equal(g.edges(1).begin(), g.edges(1).end(), edges_1.begin()));
     REQUIRE(std::equal(g.neighbors(1).begin(), g.neighbors(1).end(), edges_1.begin()));
+    auto it = g.neighbors(1).begin();
+    REQUIRE(*it++ == 2);
+    REQUIRE(it == g.neighbors(1).end());
+    REQUIRE(std::vector<node_t>(g.neighbors(1).begin(), g.neighbors(1).end()) == edges_1);
 
     REQUIRE(g.is_adjacent(0, 2) == false);
     REQUIRE(g.is_adjacent(2, 3) == true);
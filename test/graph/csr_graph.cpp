@@ -0,0 +1,81 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/analysis/connectivity.hpp"
+#include "bgl/graph/csr_graph.hpp"
+#include "bgl/graph/generator/all.hpp"
+#include "bgl/graph/visitor.hpp"
+#include "bgl/linalg/base.hpp"
+#include <algorithm>
+#include <vector>
+using namespace bgl;
+
+TEST_CASE("unweighted csr graph", "[csr-graph]") {
+  unweighted_edge_list es = {{0, 1}, {1, 2}, {2, 3}, {3, 1}, {1, 0}};
+  csr_graph g = es;
+
+  SECTION("basic") {
+    REQUIRE(g.num_nodes() == 4);
+    REQUIRE(g.num_edges() == 5);
+    REQUIRE(g.outdegree(1) == 2);
+
+    std::vector<node_t> edges_1 = {0, 2};
+    REQUIRE(g.edges(1).size() == 2);
+    REQUIRE(std::equal(g.edges(1).begin(), g.edges(1).end(), edges_1.begin()));
+    REQUIRE(std::equal(g.neighbors(1).begin(), g.neighbors(1).end(), edges_1.begin()));
+
+    REQUIRE(g.is_adjacent(0, 2) == false);
+    REQUIRE(g.is_adjacent(2, 3) == true);
+    REQUIRE(g.is_adjacent(3, 2) == false);
+
+    graph g2 = es;
+    REQUIRE(g.get_edge_list() == g2.get_edge_list());
+    REQUIRE(g.to_basic_graph() == g2);
+    REQUIRE(csr_graph(g2) == g);
+
+    csr_graph g3 = g;
+    REQUIRE(g3 == g);
+    REQUIRE(csr_graph().num_nodes() == 0);
+  }
+
+  SECTION("transpose") {
+    csr_graph g2 = g.transposed();
+    REQUIRE(g2.num_edges() == 5);
+    REQUIRE(g2.is_adjacent(2, 3) == false);
+    REQUIRE(g2.is_adjacent(3, 2) == true);
+    REQUIRE(g2.to_basic_graph() == g.to_basic_graph().transpose());
+  }
+
+  SECTION("algorithms") {
+    int inf = std::numeric_limits<int>::max();
+    REQUIRE(single_source_distance(g, 2) == std::vector<int>{3, 2, 0, 1});
+    REQUIRE(single_source_distance(g, 0) == std::vector<int>{0, 1, 2, 3});
+
+    csr_graph g2 = gen::grid(3, 3);
+    REQUIRE(single_source_distance(g2, 0) == std::vector<int>{0, 1, 2, 1, 2, 3, 2, 3, 4});
+
+    csr_graph g3 = unweighted_edge_list{{0, 1}, {1, 0}, {2, 1}};
+    REQUIRE(single_source_distance(g3, 0) == std::vector<int>{0, 1, inf});
+    REQUIRE(strongly_connected_components(g3).first == 2);
+    REQUIRE(strongly_connected_components(g3) ==
+            strongly_connected_components(g3.to_basic_graph()));
+  }
+}
+
+TEST_CASE("weighted csr graph", "[csr-graph]") {
+  weighted_edge_list<double> es = {{0, {1, 1.5}}, {1, {2, 20}}, {2, {3, 5}}, {3, {1, 0.25}}};
+  csr_wgraph<double> g = es;
+
+  SECTION("basic") {
+    REQUIRE(g.get_weight(0, 2).value_or(0) == 0);
+    REQUIRE(g.get_weight(2, 3).value_or(0) == 5);
+    REQUIRE(g.edge(3, 0) == weighted_edge_t<double>{1, 0.25});
+    REQUIRE(single_source_distance(g, 0) == std::vector<double>{0, 1.5, 21.5, 26.5});
+  }
+
+  SECTION("matrix-vector multiplication") {
+    real_vector x(4, 2.0);
+    real_vector y1 = g * x;
+    real_vector y2 = wgraph<double>(es) * x;
+    REQUIRE(y1 == y2);
+    REQUIRE(y1[1] == 40.0);
+  }
+}
@@ -0,0 +1,57 @@
+#include "../extlib/catch.hpp"
+#include "bgl/graph/intersection.hpp"
+#include "bgl/util/random.hpp"
+#include <algorithm>
+#include <iterator>
+#include <random>
+using namespace bgl;
+
+namespace {
+std::vector<node_t> random_sorted_nodes(std::size_t size, node_t max_node, std::mt19937 &rng) {
+  std::uniform_int_distribution<node_t> uid(0, max_node);
+  std::vector<node_t> result(size);
+  for (node_t &v : result) v = uid(rng);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+}  // namespace
+
+TEST_CASE("intersection", "[graph]") {
+  std::vector<node_t> xs = {1, 3, 4, 8, 10, 11, 12, 13, 14, 15, 20, 21, 30};
+  std::vector<node_t> ys = {0, 3, 5, 8, 9, 10, 11, 12, 15, 16, 17, 18, 19, 30, 31};
+  std::vector<node_t> out;
+  intersection(xs, ys, out);
+  REQUIRE(out == std::vector<node_t>{3, 8, 10, 11, 12, 15, 30});
+  REQUIRE(intersection_size(xs, ys) == 7);
+  REQUIRE(intersection_size(xs, std::vector<node_t>{}) == 0);
+  REQUIRE(*gallop(xs.begin(), xs.end(), 9) == 10);
+  REQUIRE(gallop(xs.begin(), xs.end(), 31) == xs.end());
+
+  // weighted edges: callback receives elements of both lists
+  weighted_edge_list<int> ws = {{0, {3, 30}}, {0, {7, 70}}, {0, {15, 150}}};
+  std::vector<weighted_edge_t<int>> es;
+  for (const auto &e : ws) es.push_back(e.second);
+  int sum = 0;
+  for_each_intersection(xs, es, fn(x, e) { sum += x + weight(e); });
+  REQUIRE(sum == 3 + 30 + 15 + 150);
+
+  // random lists of balanced and skewed sizes
+  std::mt19937 rng(1);
+  for (std::size_t nx : {0, 5, 17, 100, 1000}) {
+    for (std::size_t ny : {0, 8, 64, 1000, 100000}) {
+      INFO("nx = " << nx << ", ny = " << ny);
+      auto a = random_sorted_nodes(nx, 3 * std::max(nx, ny), rng);
+      auto b = random_sorted_nodes(ny, 3 * std::max(nx, ny), rng);
+      std::vector<node_t> expected;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+      intersection(a, b, out);
+      REQUIRE(out == expected);
+      intersection(b, a, out);
+      REQUIRE(out == expected);
+      REQUIRE(intersection_size(a, b) == expected.size());
+      REQUIRE(intersection_size(edge_range<node_t>(b.data(), b.data() + b.size()), a) ==
+              expected.size());
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include "../extlib/catch.hpp"
 #include "bgl/graph/io.hpp"
+#include <fstream>
 #include <iostream>
+#include <sstream>
 using namespace bgl;
 
 TEST_CASE("graph I/O", "[graph-io]") {
@@ -15,10 +17,136 @@ TEST_CASE("graph I/O", "[graph-io]") {
   graph g3 = read_graph<graph>("datasets/karate.out.tsv");
   REQUIRE(g == g3);
 
-  write_graph_binary("datasets/karate.out.bgl", g);
+  write_graph_binary("datasets/karate.out.bgl", g, 1);
   graph g4 = read_graph<graph>("datasets/karate.out.bgl");
   REQUIRE(g == g4);
 
+  write_graph_binary("datasets/karate.out.v2.bgl", g);
+  graph g5 = read_graph<graph>("datasets/karate.out.v2.bgl");
+  REQUIRE(g == g5);
+
+  csr_graph c1 = read_graph<csr_graph>("datasets/karate.tsv");
+  csr_graph c2 = map_graph_binary<csr_graph>("datasets/karate.out.bgl");
+  csr_graph c3 = map_graph_binary<csr_graph>("datasets/karate.out.v2.bgl");
+  csr_graph c4 = read_graph_binary<csr_graph>("datasets/karate.out.v2.bgl");
+  REQUIRE(c1 == csr_graph(g));
+  REQUIRE(c2 == c1);
+  REQUIRE(c3 == c1);
+  REQUIRE(c4 == c1);
+
+  binary_graph_reader<graph> reader("datasets/karate.out.v2.bgl");
+  REQUIRE(reader.num_nodes() == 34);
+  REQUIRE(reader.edges(33) == g.edges(33));
+  graph g6 = read_graph_binary_range<graph>("datasets/karate.out.v2.bgl", 10, 20);
+  csr_graph c5 = read_graph_binary_range<csr_graph>("datasets/karate.out.v2.bgl", 10, 20);
+  REQUIRE(g6.num_nodes() == 34);
+  REQUIRE(c5.to_basic_graph() == g6);
+  for (node_t v : g.nodes()) {
+    REQUIRE(g6.edges(v) == (10 <= v && v < 20 ? g.edges(v) : std::vector<node_t>{}));
+  }
+
+  write_graph("datasets/karate.out.tsv.zst", g);
+  write_graph_binary_zstd("datasets/karate.out.bgl.zst", g, 19, 2);
+  REQUIRE(read_graph<graph>("datasets/karate.out.tsv.zst") == g);
+  REQUIRE(read_graph<graph>("datasets/karate.out.bgl.zst") == g);
+  REQUIRE(read_graph<csr_graph>("datasets/karate.out.tsv.zst") == c1);
+  REQUIRE(read_graph<csr_graph>("datasets/karate.out.bgl.zst") == c1);
+  REQUIRE(!read_graph_optional<wgraph<int>>("datasets/karate.out.bgl.zst", true).has_value());
+
   path::remove("datasets/karate.out.tsv");
+  path::remove("datasets/karate.out.tsv.zst");
+  path::remove("datasets/karate.out.bgl.zst");
   path::remove("datasets/karate.out.bgl");
+  path::remove("datasets/karate.out.v2.bgl");
+}
+
+TEST_CASE("corrupted offset table", "[graph-io]") {
+  graph g = read_graph<graph>("datasets/karate.tsv");
+  write_graph_binary("datasets/karate.out.v2.bgl", g);
+
+  // zero out offset of node 11 so that the degree of node 10 underflows
+  {
+    std::fstream fs("datasets/karate.out.v2.bgl",
+                    std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    std::uint64_t corrupted = binary_header{}.offsets_position() + 8 * 11;
+    fs.seekp(corrupted);
+    std::uint64_t zero = 0;
+    fs.write(reinterpret_cast<const char *>(&zero), sizeof(zero));
+    REQUIRE(fs);
+  }
+
+  binary_graph_reader<graph> reader("datasets/karate.out.v2.bgl");
+  std::vector<std::uint64_t> offsets = reader.read_offsets(0, reader.num_nodes());
+  REQUIRE(offsets[11] < offsets[10]);
+  REQUIRE(!is_valid_offset_table(offsets.data(), reader.num_nodes(), reader.num_edges()));
+
+  path::remove("datasets/karate.out.v2.bgl");
+}
+
+TEST_CASE("weighted graph binary I/O", "[graph-io]") {
+  weighted_edge_list<double> es = {{0, {1, 1.5}}, {1, {2, 20}}, {2, {3, 5}}, {3, {1, 0.25}}};
+  wgraph<double> g = es;
+
+  for (int version : {1, 2}) {
+    write_graph_binary("datasets/weighted.out.bgl", g, version);
+    REQUIRE(read_graph<wgraph<double>>("datasets/weighted.out.bgl") == g);
+    REQUIRE(read_graph<csr_wgraph<double>>("datasets/weighted.out.bgl") == csr_wgraph<double>(g));
+    REQUIRE(!read_graph_binary_optional<graph>("datasets/weighted.out.bgl", true).has_value());
+    REQUIRE(!map_graph_binary_optional<csr_graph>("datasets/weighted.out.bgl", true).has_value());
+  }
+
+  path::remove("datasets/weighted.out.bgl");
+}
+
+TEST_CASE("tsv parsing", "[graph-io]") {
+  std::istringstream iss1("# weight type: double\r\n0 1 1.5\r\n\r\n1\t2 +2e1\r\n2 3 5\n3 1 0.25");
+  REQUIRE(read_graph_tsv<wgraph<double>>(iss1).get_edge_list() ==
+          weighted_edge_list<double>{{0, {1, 1.5}}, {1, {2, 20}}, {2, {3, 5}}, {3, {1, 0.25}}});
+
+  std::istringstream iss2("# weight type: double\n0 1 1.5\n");
+  REQUIRE(!read_graph_tsv_optional<graph>(iss2, true).has_value());
+
+  std::istringstream iss3("0 1\n1 2\n");
+  REQUIRE(!read_graph_tsv_optional<wgraph<int>>(iss3, true).has_value());
+
+  // input spanning multiple chunks
+  unweighted_edge_list es;
+  for (node_t v : irange(1 << 19)) {
+    es.emplace_back(v, (v * 7919 + 13) % (1 << 19));
+    es.emplace_back(v, (v * 104729 + 1) % (1 << 19));
+  }
+  graph g = es;
+  std::stringstream ss;
+  write_graph_tsv(ss, g);
+  REQUIRE(ss.str().size() > (1 << 23));
+  graph g2 = read_graph_tsv_optional<graph>(ss, false, 4).value();
+  REQUIRE(g2 == g);
+  ss.clear();
+  ss.seekg(0);
+  REQUIRE(read_graph_tsv<csr_graph>(ss) == csr_graph(g));
+
+  // stream read by multiple batches with partial lines carried over
+  ss.clear();
+  ss.seekg(0);
+  REQUIRE(read_graph_tsv_optional<graph>(ss, false, 1).value() == g);
+
+  // compressed input of multiple frames (decompressed in parallel from file, on the fly from
+  // stream) and of a single frame
+  write_graph_tsv_zstd("datasets/large.out.tsv.zst", g, 1, 4);
+  write_graph_binary_zstd("datasets/large.out.bgl.zst", g, 1, 4);
+  REQUIRE(read_graph_tsv_zstd<graph>("datasets/large.out.tsv.zst") == g);
+  REQUIRE(read_graph_binary_zstd<csr_graph>("datasets/large.out.bgl.zst") == csr_graph(g));
+  std::ifstream ifs("datasets/large.out.tsv.zst", std::ios_base::binary);
+  REQUIRE(read_graph_tsv_zstd<csr_graph>(ifs) == csr_graph(g));
+  std::ifstream ifs2("datasets/large.out.bgl.zst", std::ios_base::binary);
+  REQUIRE(read_graph_binary_zstd<graph>(ifs2) == g);
+  {
+    std::string text = ss.str();
+    std::string compressed = zstd_compress(text.data(), text.size(), 1, text.size());
+    std::ofstream ofs("datasets/large.out.tsv.zst", std::ios_base::binary);
+    ofs.write(compressed.data(), compressed.size());
+  }
+  REQUIRE(read_graph_tsv_zstd<graph>("datasets/large.out.tsv.zst") == g);
+  path::remove("datasets/large.out.tsv.zst");
+  path::remove("datasets/large.out.bgl.zst");
 }
@@ -7,17 +7,19 @@
 using namespace bgl;
 
 TEST_CASE("linsolve", "[lu][gmres][linalg]") {
+  // a local generator keeps the random matrices independent of other tests
+  rng_t rng;
   const int n = 30;
   sparse_matrix A(n);
   for (int i : irange(n)) {
     for (int j : irange(n)) {
-      if (i == j || bgl_random() < 0.2 * static_cast<double>(rng_t::max())) {
-        A.add_edge(i, {j, static_cast<double>(bgl_random()) / static_cast<double>(rng_t::max())});
+      if (i == j || rng() < 0.2 * static_cast<double>(rng_t::max())) {
+        A.add_edge(i, {j, static_cast<double>(rng()) / static_cast<double>(rng_t::max())});
       }
     }
   }
 
-  const real_vector b = generate_random_unit_vector(n);
+  const real_vector b = generate_random_unit_vector(n, rng);
   auto LU = lu_decomposition(A);
   auto ILU = ilu_decomposition(A, n);
   auto ILU0 = ilu_decomposition(A, 0);
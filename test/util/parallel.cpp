@@ -0,0 +1,66 @@
+#include "../extlib/catch.hpp"
+#include "bgl/util/parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+using namespace bgl;
+
+TEST_CASE("parallel for-loop", "[util]") {
+  const std::size_t n = 100000;
+
+  SECTION("every index is visited once") {
+    std::vector<std::atomic<int>> visited(n);
+    std::atomic<bool> valid_thread_id = true;
+    parallel_for(
+        n, 16,
+        fn(i, t) {
+          visited[i]++;
+          if (t < 0 || t >= 4) valid_thread_id = false;
+        },
+        4);
+    REQUIRE(std::all_of(visited.begin(), visited.end(), fn(x) { return x == 1; }));
+    REQUIRE(valid_thread_id);
+  }
+
+  SECTION("weighted") {
+    std::atomic<std::size_t> sum = 0;
+    auto weight = fn(i) { return i % 1000 == 0 ? 100000 : 1; };
+    parallel_for_weighted(n, 1000, weight, fn(i, t [[maybe_unused]]) { sum += i; }, 3);
+    REQUIRE(sum == n * (n - 1) / 2);
+  }
+
+  SECTION("nested") {
+    std::atomic<std::size_t> count = 0;
+    parallel_for(
+        100, 1,
+        fn(i [[maybe_unused]], t [[maybe_unused]]) {
+          parallel_for(100, 1, fn(j [[maybe_unused]], u [[maybe_unused]]) { count++; }, 2);
+        },
+        4);
+    REQUIRE(count == 10000);
+  }
+
+  SECTION("thread pool") {
+    thread_pool pool(3);
+    std::vector<int> ids(3, -1);
+    for (int rep [[maybe_unused]] : irange(10)) {
+      pool.run(3, fn(t) { ids[t] = t; });
+    }
+    REQUIRE(ids == std::vector<int>{0, 1, 2});
+
+    // nested job on the caller thread, and a job throwing on the caller thread
+    std::atomic<int> count = 0;
+    pool.run(3, fn(t [[maybe_unused]]) { pool.run(2, fn(u [[maybe_unused]]) { count++; }); });
+    REQUIRE(count == 6);
+    REQUIRE_THROWS(pool.run(3, fn(t) {
+      if (t == 0) throw std::runtime_error("error");
+    }));
+    ids.assign(3, -1);
+    pool.run(3, fn(t) { ids[t] = t; });
+    REQUIRE(ids == std::vector<int>{0, 1, 2});
+
+    pool.resize(2);
+    REQUIRE(pool.size() == 2);
+  }
+}
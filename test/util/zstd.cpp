@@ -0,0 +1,62 @@
+#include "../extlib/catch.hpp"
+#include "bgl/util/zstd.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace bgl;
+
+TEST_CASE("zstd", "[util]") {
+  std::string s;
+  for (int i : irange(100000)) {
+    s += std::to_string(i * i) + "\n";
+  }
+
+  SECTION("multiple frames") {
+    std::string compressed = zstd_compress(s.data(), s.size(), 3, 1 << 16, 4);
+    REQUIRE(zstd_frames(compressed.data(), compressed.size()).size() == s.size() / (1 << 16) + 1);
+    std::vector<char> decompressed = zstd_decompress(compressed.data(), compressed.size(), 4);
+    REQUIRE(std::string(decompressed.begin(), decompressed.end()) == s);
+
+    std::istringstream iss(compressed);
+    zstd_decode_filter_buf buf(iss.rdbuf());
+    std::istream is(&buf);
+    std::ostringstream oss;
+    oss << is.rdbuf();
+    REQUIRE(oss.str() == s);
+  }
+
+  SECTION("frames without content size") {
+    // streaming compression does not record content size in frame header
+    std::string compressed(ZSTD_compressBound(s.size()) * 2, '\0');
+    std::size_t pos = 0;
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    for (std::size_t i : irange(2)) {
+      std::size_t first = i * s.size() / 2, last = (i + 1) * s.size() / 2;
+      ZSTD_inBuffer input = {s.data() + first, last - first, 0};
+      ZSTD_outBuffer output = {compressed.data() + pos, compressed.size() - pos, 0};
+      ZSTD_compressStream2(cctx, &output, &input, ZSTD_e_continue);
+      REQUIRE(ZSTD_compressStream2(cctx, &output, &input, ZSTD_e_end) == 0);
+      pos += output.pos;
+    }
+    ZSTD_freeCCtx(cctx);
+    compressed.resize(pos);
+    REQUIRE(ZSTD_getFrameContentSize(compressed.data(), pos) == ZSTD_CONTENTSIZE_UNKNOWN);
+
+    std::vector<char> decompressed = zstd_decompress(compressed.data(), compressed.size());
+    REQUIRE(std::string(decompressed.begin(), decompressed.end()) == s);
+  }
+
+  SECTION("encode filter") {
+    std::stringstream ss;
+    {
+      zstd_encode_filter_buf buf(ss.rdbuf(), 1, 2);
+      std::ostream os(&buf);
+      for (std::size_t i = 0; i < 200; ++i) os.write(s.data(), s.size());
+    }
+    std::string compressed = ss.str();
+    REQUIRE(zstd_frames(compressed.data(), compressed.size()).size() > 1);
+    std::vector<char> decompressed = zstd_decompress(compressed.data(), compressed.size());
+    REQUIRE(decompressed.size() == s.size() * 200);
+    REQUIRE(std::string(decompressed.end() - s.size(), decompressed.end()) == s);
+  }
+}